@@ -0,0 +1,336 @@
+// Local admin HTTP endpoint serving the metrics registry to scrapers, mission
+// traces (/trace) and rendered frames of the world (/frame.png, /frame.ppm).
+// Non-blocking sockets driven by the server's poll() loop; one request per
+// connection, answered and closed. poll() rather than select(): with a
+// large fleet connected these fds are numbered past FD_SETSIZE.
+#include "headers/admin_http.h"
+#include "headers/metrics.h"
+#include "headers/lockprof.h"
+#include "headers/trace.h"
+#include "headers/offscreen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define ADMIN_MAX_CONNECTIONS (ADMIN_POLL_FDS - 2)
+#define ADMIN_REQUEST_MAX 2048
+
+typedef struct {
+    int fd;                 // -1 when the slot is free
+    size_t in_len;
+    char in[ADMIN_REQUEST_MAX];
+    char *out;              // response, NULL until the request is complete
+    size_t out_len;
+    size_t out_sent;
+    int frame_wait;         // waiting for the frame thread to answer frame_seq
+    FrameFormat frame_format;
+    unsigned long frame_seq;
+} AdminConnection;
+
+static int admin_sock = -1;
+static AdminConnection connections[ADMIN_MAX_CONNECTIONS];
+
+// Histogram bucket boundaries exported as "le", in seconds
+static const double export_bounds[] = {
+    1e-6, 1e-5, 1e-4, 5e-4, 1e-3, 5e-3, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 30, 60, 300
+};
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t capacity;
+} Text;
+
+static void text_append(Text *t, const char *data, size_t len) {
+    if (t->len + len > t->capacity) {
+        size_t capacity = t->capacity ? t->capacity * 2 : 4096;
+        while (capacity < t->len + len) capacity *= 2;
+        char *grown = realloc(t->data, capacity);
+        if (!grown) return;
+        t->data = grown;
+        t->capacity = capacity;
+    }
+    memcpy(t->data + t->len, data, len);
+    t->len += len;
+}
+
+static void text_printf(Text *t, const char *fmt, ...) {
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        size_t room = t->capacity - t->len;
+        int n = vsnprintf(t->data ? t->data + t->len : NULL, room, fmt, ap);
+        va_end(ap);
+        if (n < 0) return;
+        if ((size_t)n < room) {
+            t->len += (size_t)n;
+            return;
+        }
+        size_t capacity = t->capacity ? t->capacity * 2 : 4096;
+        while (capacity - t->len <= (size_t)n) capacity *= 2;
+        char *data = realloc(t->data, capacity);
+        if (!data) return;
+        t->data = data;
+        t->capacity = capacity;
+    }
+}
+
+// "# HELP"/"# TYPE" once per family; families are adjacent in the tables
+static void family_header(Text *t, const MetricDesc *desc, const MetricDesc *prev, const char *type) {
+    if (prev && strcmp(prev->name, desc->name) == 0) return;
+    text_printf(t, "# HELP %s %s\n# TYPE %s %s\n", desc->name, desc->help, desc->name, type);
+}
+
+static void sample(Text *t, const char *name, const char *suffix, const char *labels, const char *value) {
+    if (labels[0]) text_printf(t, "%s%s{%s} %s\n", name, suffix, labels, value);
+    else text_printf(t, "%s%s %s\n", name, suffix, value);
+}
+
+// Buckets, sum and count of one histogram series (recorded in ns, exported in seconds)
+static void render_histogram(Text *t, const char *name, const char *labels, const Histogram *h) {
+    char value[64], le_labels[160];
+    const char *sep = labels[0] ? "," : "";
+    for (size_t b = 0; b < sizeof(export_bounds) / sizeof(export_bounds[0]); b++) {
+        snprintf(le_labels, sizeof(le_labels), "%s%sle=\"%g\"", labels, sep, export_bounds[b]);
+        snprintf(value, sizeof(value), "%llu",
+                 (unsigned long long)histogram_count_at_most(h, (uint64_t)(export_bounds[b] * 1e9)));
+        sample(t, name, "_bucket", le_labels, value);
+    }
+    snprintf(le_labels, sizeof(le_labels), "%s%sle=\"+Inf\"", labels, sep);
+    snprintf(value, sizeof(value), "%llu", (unsigned long long)h->count);
+    sample(t, name, "_bucket", le_labels, value);
+    snprintf(value, sizeof(value), "%.9f", h->sum / 1e9);
+    sample(t, name, "_sum", labels, value);
+    snprintf(value, sizeof(value), "%llu", (unsigned long long)h->count);
+    sample(t, name, "_count", labels, value);
+}
+
+#ifdef LOCK_PROFILING
+static void render_lock_stats(Text *t) {
+    LockStats *stats = malloc(sizeof(LockStats) * LOCKPROF_MAX_LOCKS);
+    if (!stats) return;
+    int count = lockprof_snapshot(stats, LOCKPROF_MAX_LOCKS);
+    char labels[96];
+    text_printf(t, "# HELP lock_acquisitions_total Acquisitions of profiled locks\n# TYPE lock_acquisitions_total counter\n");
+    for (int i = 0; i < count; i++)
+        text_printf(t, "lock_acquisitions_total{lock=\"%s\"} %llu\n", stats[i].name, (unsigned long long)stats[i].acquisitions);
+    text_printf(t, "# HELP lock_contended_total Acquisitions that found the lock taken\n# TYPE lock_contended_total counter\n");
+    for (int i = 0; i < count; i++)
+        text_printf(t, "lock_contended_total{lock=\"%s\"} %llu\n", stats[i].name, (unsigned long long)stats[i].contended);
+    text_printf(t, "# HELP lock_wait_seconds Time spent waiting to acquire a lock\n# TYPE lock_wait_seconds histogram\n");
+    for (int i = 0; i < count; i++) {
+        snprintf(labels, sizeof(labels), "lock=\"%s\"", stats[i].name);
+        render_histogram(t, "lock_wait_seconds", labels, &stats[i].wait);
+    }
+    text_printf(t, "# HELP lock_hold_seconds Time a lock was held\n# TYPE lock_hold_seconds histogram\n");
+    for (int i = 0; i < count; i++) {
+        snprintf(labels, sizeof(labels), "lock=\"%s\"", stats[i].name);
+        render_histogram(t, "lock_hold_seconds", labels, &stats[i].hold);
+    }
+    free(stats);
+}
+#endif
+
+static void render_prometheus(Text *t) {
+    MetricsSnapshot *m = malloc(sizeof(MetricsSnapshot));
+    if (!m) return;
+    metrics_snapshot(m);
+    char value[64];
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        family_header(t, &counter_desc[i], i ? &counter_desc[i - 1] : NULL, "counter");
+        snprintf(value, sizeof(value), "%llu", (unsigned long long)m->counters[i]);
+        sample(t, counter_desc[i].name, "", counter_desc[i].labels, value);
+    }
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        family_header(t, &gauge_desc[i], i ? &gauge_desc[i - 1] : NULL, "gauge");
+        snprintf(value, sizeof(value), "%lld", (long long)m->gauges[i]);
+        sample(t, gauge_desc[i].name, "", gauge_desc[i].labels, value);
+    }
+    // Derived: idle/busy split of the fleet
+    int64_t busy = m->gauges[GAUGE_DRONES_ON_MISSION];
+    int64_t idle = m->gauges[GAUGE_DRONES_CONNECTED] - busy;
+    text_printf(t, "# HELP drones_by_state Registered drones by state\n# TYPE drones_by_state gauge\n");
+    text_printf(t, "drones_by_state{state=\"idle\"} %lld\ndrones_by_state{state=\"busy\"} %lld\n",
+                (long long)(idle > 0 ? idle : 0), (long long)busy);
+    for (int i = 0; i < HISTOGRAM_COUNT; i++) {
+        family_header(t, &histogram_desc[i], i ? &histogram_desc[i - 1] : NULL, "histogram");
+        render_histogram(t, histogram_desc[i].name, histogram_desc[i].labels, &m->histograms[i]);
+    }
+#ifdef LOCK_PROFILING
+    render_lock_stats(t);
+#endif
+    free(m);
+}
+
+static void respond(AdminConnection *c, const char *status, const char *content_type, Text *body) {
+    Text t = {0};
+    text_printf(&t, "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                status, content_type, body->len);
+    if (body->len) text_append(&t, body->data, body->len);   // may be binary
+    c->out = t.data;
+    c->out_len = t.len;
+    c->out_sent = 0;
+}
+
+static void handle_request(AdminConnection *c) {
+    Text body = {0};
+    if (strncmp(c->in, "GET /metrics ", 13) == 0 || strncmp(c->in, "GET /metrics?", 13) == 0) {
+        render_prometheus(&body);
+        respond(c, "200 OK", "text/plain; version=0.0.4; charset=utf-8", &body);
+    } else if (strncmp(c->in, "GET /trace ", 11) == 0) {
+        // Mission spans so far, e.g. curl -o missions.json .../trace
+        FILE *out = open_memstream(&body.data, &body.len);
+        if (out) {
+            trace_write_chrome(out);
+            fclose(out);
+        }
+        respond(c, "200 OK", "application/json", &body);
+    } else if (strncmp(c->in, "GET /frame.png ", 15) == 0 || strncmp(c->in, "GET /frame.ppm ", 15) == 0) {
+        // The whole map as it is now, e.g. curl -o world.png .../frame.png.
+        // Rendered off this loop; answered by frame_ready()
+        c->frame_format = c->in[12] == 'n' ? FRAME_PNG : FRAME_PPM;
+        if (offscreen_request(c->frame_format, &c->frame_seq) == 0) {
+            c->frame_wait = 1;
+        } else {
+            text_printf(&body, "render failed\n");
+            respond(c, "500 Internal Server Error", "text/plain", &body);
+        }
+    } else {
+        text_printf(&body, "not found\n");
+        respond(c, "404 Not Found", "text/plain", &body);
+    }
+    free(body.data);
+}
+
+// Answer connections whose frame the frame thread has finished
+static void frame_ready(void) {
+    char drain[64];
+    while (read(offscreen_notify_fd(), drain, sizeof(drain)) > 0) {}
+    for (int i = 0; i < ADMIN_MAX_CONNECTIONS; i++) {
+        AdminConnection *c = &connections[i];
+        if (c->fd < 0 || !c->frame_wait) continue;
+        Text body = {0};
+        int ready = offscreen_collect(c->frame_format, c->frame_seq, &body.data, &body.len);
+        if (ready == 0) continue;
+        c->frame_wait = 0;
+        if (ready > 0) {
+            respond(c, "200 OK", c->frame_format == FRAME_PNG ? "image/png" : "image/x-portable-pixmap", &body);
+        } else {
+            text_printf(&body, "render failed\n");
+            respond(c, "500 Internal Server Error", "text/plain", &body);
+        }
+        free(body.data);
+    }
+}
+
+static void close_connection(AdminConnection *c) {
+    close(c->fd);
+    free(c->out);
+    memset(c, 0, sizeof(*c));
+    c->fd = -1;
+}
+
+int admin_http_start(int port) {
+    for (int i = 0; i < ADMIN_MAX_CONNECTIONS; i++) connections[i].fd = -1;
+    admin_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (admin_sock < 0) return -1;
+    int one = 1;
+    setsockopt(admin_sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(admin_sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(admin_sock, ADMIN_MAX_CONNECTIONS) < 0) {
+        int err = errno;
+        close(admin_sock);
+        admin_sock = -1;
+        errno = err;
+        return -1;
+    }
+    fcntl(admin_sock, F_SETFL, fcntl(admin_sock, F_GETFL) | O_NONBLOCK);
+    return 0;
+}
+
+int admin_http_fill_fds(struct pollfd *fds) {
+    if (admin_sock < 0) return 0;
+    int count = 0;
+    fds[count++] = (struct pollfd){ .fd = admin_sock, .events = POLLIN };
+    int frame_wait = 0;
+    for (int i = 0; i < ADMIN_MAX_CONNECTIONS; i++) {
+        AdminConnection *c = &connections[i];
+        if (c->fd < 0) continue;
+        if (c->frame_wait && !c->out) {
+            frame_wait = 1;
+            continue;
+        }
+        fds[count++] = (struct pollfd){ .fd = c->fd, .events = c->out ? POLLOUT : POLLIN };
+    }
+    int notify = offscreen_notify_fd();
+    if (frame_wait && notify >= 0) fds[count++] = (struct pollfd){ .fd = notify, .events = POLLIN };
+    return count;
+}
+
+// revents poll() reported for fd, 0 if it was not polled
+static short ready_events(const struct pollfd *fds, int count, int fd) {
+    for (int i = 0; i < count; i++)
+        if (fds[i].fd == fd) return fds[i].revents;
+    return 0;
+}
+
+void admin_http_service(const struct pollfd *fds, int count) {
+    if (admin_sock < 0) return;
+    int notify = offscreen_notify_fd();
+    if (notify >= 0 && ready_events(fds, count, notify)) frame_ready();
+    for (int i = 0; i < ADMIN_MAX_CONNECTIONS; i++) {
+        AdminConnection *c = &connections[i];
+        if (c->fd < 0) continue;
+        short events = ready_events(fds, count, c->fd);
+        if (!events) continue;
+        if (!c->out && !c->frame_wait) {
+            ssize_t n = recv(c->fd, c->in + c->in_len, sizeof(c->in) - 1 - c->in_len, 0);
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+                close_connection(c);
+                continue;
+            }
+            c->in_len += (size_t)n;
+            c->in[c->in_len] = '\0';
+            // Only the request line matters; wait for the end of the headers
+            if (strstr(c->in, "\r\n\r\n") || strstr(c->in, "\n\n")) handle_request(c);
+            else if (c->in_len == sizeof(c->in) - 1) close_connection(c);
+        } else if (c->out) {
+            ssize_t n = send(c->fd, c->out + c->out_sent, c->out_len - c->out_sent, MSG_NOSIGNAL);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+            if (n <= 0) {
+                close_connection(c);
+                continue;
+            }
+            c->out_sent += (size_t)n;
+            if (c->out_sent == c->out_len) close_connection(c);
+        }
+    }
+    if (ready_events(fds, count, admin_sock)) {
+        int fd;
+        while ((fd = accept(admin_sock, NULL, NULL)) >= 0) {
+            AdminConnection *slot = NULL;
+            for (int i = 0; i < ADMIN_MAX_CONNECTIONS && !slot; i++) {
+                if (connections[i].fd < 0) slot = &connections[i];
+            }
+            if (!slot) {
+                // Busy scraper; it will retry on the next interval
+                close(fd);
+                continue;
+            }
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            slot->fd = fd;
+        }
+    }
+}
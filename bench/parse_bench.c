@@ -0,0 +1,122 @@
+// Parse throughput of cJSON on a corpus of protocol messages.
+// Built once per scanning kernel by "make bench" (see the Makefile):
+//   bench/parse_bench [corpus.jsonl] [rounds]
+// Each round splits the corpus into frames with cJSON_FindFrameEnd, as
+// FrameReader does, and parses and frees every frame. Reports the best of
+// BENCH_REPEATS runs for the whole corpus and for its longest message alone.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cJSON.h"
+
+#define BENCH_REPEATS 7
+#define BENCH_DEFAULT_ROUNDS 2000
+#define BENCH_DEFAULT_CORPUS "bench/protocol_corpus.jsonl"
+
+#if defined(CJSON_SCAN_SWAR)
+#define BENCH_KERNEL "swar"
+#elif defined(__AVX2__)
+#define BENCH_KERNEL "avx2"
+#elif defined(__SSE2__)
+#define BENCH_KERNEL "sse2"
+#else
+#define BENCH_KERNEL "swar"
+#endif
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static char *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = size > 0 ? malloc((size_t)size) : NULL;
+    if (data && fread(data, 1, (size_t)size, f) != (size_t)size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *len = data ? (size_t)size : 0;
+    return data;
+}
+
+// Parse every newline-delimited frame in buf once; returns frames parsed, -1 on a parse error
+static long parse_all(const char *buf, size_t len) {
+    long frames = 0;
+    const char *pos = buf, *end = buf + len;
+    while (pos < end) {
+        const char *nl = cJSON_FindFrameEnd(pos, (size_t)(end - pos));
+        size_t frame_len = nl ? (size_t)(nl - pos) : (size_t)(end - pos);
+        if (frame_len) {
+            cJSON *msg = cJSON_ParseWithLength(pos, frame_len);
+            if (!msg) return -1;
+            cJSON_Delete(msg);
+            frames++;
+        }
+        pos += frame_len + 1;
+    }
+    return frames;
+}
+
+static void run(const char *label, const char *buf, size_t len, int rounds) {
+    double best = 0;
+    long frames = 0;
+    for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+        double start = now_sec();
+        for (int r = 0; r < rounds; r++) {
+            frames = parse_all(buf, len);
+            if (frames < 0) {
+                fprintf(stderr, "%s: parse error\n", label);
+                exit(1);
+            }
+        }
+        double elapsed = now_sec() - start;
+        if (rep == 0 || elapsed < best) best = elapsed;
+    }
+    double bytes = (double)len * rounds, msgs = (double)frames * rounds;
+    printf("%-5s %-8s %8.1f MB/s %10.0f msg/s %7.0f ns/msg\n",
+           BENCH_KERNEL, label, bytes / best / 1e6, msgs / best, best * 1e9 / msgs);
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : BENCH_DEFAULT_CORPUS;
+    int rounds = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_ROUNDS;
+    if (rounds <= 0) rounds = BENCH_DEFAULT_ROUNDS;
+
+#if defined(__AVX2__) && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx2")) {
+        printf("avx2  skipped, the CPU has no AVX2\n");
+        return 0;
+    }
+#endif
+    size_t len;
+    char *corpus = read_file(path, &len);
+    if (!corpus) {
+        perror(path);
+        return 1;
+    }
+
+    // the longest message on its own is dominated by string scanning
+    const char *longest = corpus, *pos = corpus, *end = corpus + len;
+    size_t longest_len = 0;
+    while (pos < end) {
+        const char *nl = cJSON_FindFrameEnd(pos, (size_t)(end - pos));
+        size_t frame_len = nl ? (size_t)(nl - pos) : (size_t)(end - pos);
+        if (frame_len > longest_len) {
+            longest = pos;
+            longest_len = frame_len;
+        }
+        pos += frame_len + 1;
+    }
+
+    run("corpus", corpus, len, rounds);
+    run("longest", longest, longest_len, rounds * 50);
+    free(corpus);
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Serialization cost of the two most frequent protocol messages, built the
+// way server.c and drone_client.c build them, plus non-integral numbers on
+// their own (the Grisu2 path of print_number). Best of BENCH_REPEATS runs.
+//   bench/serialize_bench [iterations]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cJSON.h"
+
+#define BENCH_REPEATS 5
+#define BENCH_DEFAULT_ITERATIONS 200000
+#define BENCH_DOUBLES 1024
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int assign_mission(int i) {
+    cJSON *msg = cJSON_CreateObject();
+    cJSON_AddStringToObject(msg, "type", "ASSIGN_MISSION");
+    cJSON_AddStringToObject(msg, "mission_id", "M123");
+    cJSON_AddStringToObject(msg, "priority", "high");
+    cJSON *target = cJSON_CreateObject();
+    cJSON_AddNumberToObject(target, "x", i % 40);
+    cJSON_AddNumberToObject(target, "y", i % 60);
+    cJSON_AddItemToObject(msg, "target", target);
+    cJSON_AddNumberToObject(msg, "expiry", 1620003600 + i);
+    cJSON_AddStringToObject(msg, "checksum", "a1b2c3");
+    char *text = cJSON_PrintUnformatted(msg);
+    int ok = text != NULL;
+    cJSON_free(text);
+    cJSON_Delete(msg);
+    return ok;
+}
+
+static int status_update(int i) {
+    cJSON *msg = cJSON_CreateObject();
+    cJSON_AddStringToObject(msg, "type", "STATUS_UPDATE");
+    cJSON_AddStringToObject(msg, "drone_id", "D17");
+    cJSON_AddNumberToObject(msg, "timestamp", 1620000000 + i);
+    cJSON *loc = cJSON_CreateObject();
+    cJSON_AddNumberToObject(loc, "x", i % 40);
+    cJSON_AddNumberToObject(loc, "y", i % 60);
+    cJSON_AddItemToObject(msg, "location", loc);
+    cJSON_AddStringToObject(msg, "status", "busy");
+    cJSON_AddNumberToObject(msg, "battery", 100 - i % 90);
+    cJSON_AddNumberToObject(msg, "speed", 5);
+    char *text = cJSON_PrintUnformatted(msg);
+    int ok = text != NULL;
+    cJSON_free(text);
+    cJSON_Delete(msg);
+    return ok;
+}
+
+static void run(const char *label, int (*build)(int), int iterations) {
+    double best = 0;
+    for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+        int printed = 0;
+        double start = now_sec();
+        for (int i = 0; i < iterations; i++) printed += build(i);
+        double elapsed = now_sec() - start;
+        if (printed != iterations) {
+            fprintf(stderr, "%s: print failed\n", label);
+            exit(1);
+        }
+        if (rep == 0 || elapsed < best) best = elapsed;
+    }
+    printf("%-15s %7.0f ns/msg (build, print, free)\n", label, best * 1e9 / iterations);
+}
+
+static void run_doubles(int iterations) {
+    cJSON *array = cJSON_CreateArray();
+    srand(1);
+    for (int i = 0; i < BENCH_DOUBLES; i++) {
+        double value = (double)rand() / RAND_MAX * 1000.0 - 500.0;
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(value));
+    }
+    int rounds = iterations / BENCH_DOUBLES + 1;
+    double best = 0;
+    for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+        double start = now_sec();
+        for (int r = 0; r < rounds; r++) {
+            char *text = cJSON_PrintUnformatted(array);
+            cJSON_free(text);
+        }
+        double elapsed = now_sec() - start;
+        if (rep == 0 || elapsed < best) best = elapsed;
+    }
+    cJSON_Delete(array);
+    printf("%-15s %7.1f ns/number\n", "doubles", best * 1e9 / ((double)rounds * BENCH_DOUBLES));
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations <= 0) iterations = BENCH_DEFAULT_ITERATIONS;
+    run("ASSIGN_MISSION", assign_mission, iterations);
+    run("STATUS_UPDATE", status_update, iterations);
+    run_doubles(iterations);
+    return 0;
+}
@@ -49,6 +49,21 @@
 #include <locale.h>
 #endif
 
+/* pick the widest byte scanning kernel the target supports, see scan_for_bytes;
+ * define CJSON_SCAN_SWAR to force the word-at-a-time kernel (bench/parse_bench) */
+#if defined(CJSON_SCAN_SWAR)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define CJSON_SCAN_AVX2
+#define CJSON_SCAN_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CJSON_SCAN_SSE2
+#endif
+#if defined(_MSC_VER) && defined(CJSON_SCAN_SSE2)
+#include <intrin.h>
+#endif
+
 #if defined(_MSC_VER)
 #pragma warning (pop)
 #endif
@@ -303,6 +318,153 @@ typedef struct
 /* get a pointer to the buffer at the position */
 #define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
 
+/* index of the lowest set bit of a non-zero movemask */
+#if defined(CJSON_SCAN_SSE2)
+#if defined(_MSC_VER)
+static unsigned int first_set_bit(unsigned int mask)
+{
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return (unsigned int)index;
+}
+#else
+#define first_set_bit(mask) ((unsigned int)__builtin_ctz(mask))
+#endif
+#endif
+
+/* SWAR helpers for targets without SSE2: work on one machine word at a time */
+#define word_ones (((size_t)-1) / 0xFF)
+#define word_highs (word_ones * 0x80)
+#define word_has_zero_byte(word) ((((word) - word_ones) & ~(word)) & word_highs)
+
+/* Find the first byte equal to a or b in [start, end). Returns end if there is none.
+ * Never reads outside of [start, end), so it is safe on buffers that are not padded. */
+static const unsigned char *scan_for_bytes(const unsigned char *start, const unsigned char *end, unsigned char a, unsigned char b)
+{
+    const unsigned char *pointer = start;
+#if defined(CJSON_SCAN_AVX2)
+    const __m256i wide_a = _mm256_set1_epi8((char)a);
+    const __m256i wide_b = _mm256_set1_epi8((char)b);
+    while ((size_t)(end - pointer) >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(const void*)pointer);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, wide_a), _mm256_cmpeq_epi8(chunk, wide_b)));
+        if (mask != 0)
+        {
+            return pointer + first_set_bit(mask);
+        }
+        pointer += 32;
+    }
+#endif
+#if defined(CJSON_SCAN_SSE2)
+    {
+        const __m128i narrow_a = _mm_set1_epi8((char)a);
+        const __m128i narrow_b = _mm_set1_epi8((char)b);
+        while ((size_t)(end - pointer) >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)pointer);
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, narrow_a), _mm_cmpeq_epi8(chunk, narrow_b)));
+            if (mask != 0)
+            {
+                return pointer + first_set_bit(mask);
+            }
+            pointer += 16;
+        }
+    }
+#else
+    {
+        const size_t pattern_a = word_ones * a;
+        const size_t pattern_b = word_ones * b;
+        while ((size_t)(end - pointer) >= sizeof(size_t))
+        {
+            size_t word = 0;
+            memcpy(&word, pointer, sizeof(word));
+            if (word_has_zero_byte(word ^ pattern_a) || word_has_zero_byte(word ^ pattern_b))
+            {
+                /* the exact position is found by the byte loop below */
+                break;
+            }
+            pointer += sizeof(size_t);
+        }
+    }
+#endif
+    while ((pointer < end) && (*pointer != a) && (*pointer != b))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+
+/* Skip bytes <= 32 (whitespace, cr/lf and control characters) in [start, end).
+ * Returns end if everything up to it is whitespace. */
+static const unsigned char *scan_past_whitespace(const unsigned char *start, const unsigned char *end)
+{
+    const unsigned char *pointer = start;
+
+    /* unformatted JSON almost never has whitespace, so check the first byte before vectorising */
+    if ((pointer >= end) || (*pointer > 32))
+    {
+        return pointer;
+    }
+#if defined(CJSON_SCAN_AVX2)
+    {
+        const __m256i wide_space = _mm256_set1_epi8(32);
+        while ((size_t)(end - pointer) >= 32)
+        {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)(const void*)pointer);
+            /* max(byte, 32) == 32 exactly when byte <= 32 */
+            unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(chunk, wide_space), wide_space));
+            if (mask != 0)
+            {
+                return pointer + first_set_bit(mask);
+            }
+            pointer += 32;
+        }
+    }
+#endif
+#if defined(CJSON_SCAN_SSE2)
+    {
+        const __m128i narrow_space = _mm_set1_epi8(32);
+        while ((size_t)(end - pointer) >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)pointer);
+            unsigned int mask = 0xFFFFu & ~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, narrow_space), narrow_space));
+            if (mask != 0)
+            {
+                return pointer + first_set_bit(mask);
+            }
+            pointer += 16;
+        }
+    }
+#endif
+    while ((pointer < end) && (*pointer <= 32))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+
+CJSON_PUBLIC(const char *) cJSON_FindFrameEnd(const char *buffer, size_t length)
+{
+    const unsigned char *start = (const unsigned char*)buffer;
+    const unsigned char *found = NULL;
+
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+
+    found = scan_for_bytes(start, start + length, '\n', '\n');
+    if (found == (start + length))
+    {
+        return NULL;
+    }
+
+    return (const char*)found;
+}
+
 /* Parse the input text to generate a number, and populate the result into item. */
 static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
 {
@@ -587,16 +749,392 @@ static cJSON_bool compare_double(double a, double b)
     return (fabs(a - b) <= maxVal * DBL_EPSILON);
 }
 
+/* Shortest round-trip double formatting (Grisu2, after Florian Loitsch's
+ * "Printing Floating-Point Numbers Quickly and Accurately with Integers").
+ * The digits always read back to the same double, so no sscanf check is needed. */
+typedef struct
+{
+    unsigned long long f;
+    int e;
+} diy_fp;
+
+#define dp_significand_mask 0x000FFFFFFFFFFFFFULL
+#define dp_hidden_bit 0x0010000000000000ULL
+#define dp_exponent_bias (0x3FF + 52)
+
+/* normalized 64 bit significands and binary exponents of 10^-348, 10^-340, ..., 10^340 */
+static const unsigned long long cached_powers_f[] =
+{
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+static const short cached_powers_e[] =
+{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+static const unsigned long long powers_of_ten[] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static diy_fp diy_fp_make(unsigned long long f, int e)
+{
+    diy_fp result;
+    result.f = f;
+    result.e = e;
+    return result;
+}
+
+/* rounded upper 64 bits of the 128 bit product */
+static diy_fp diy_fp_multiply(diy_fp a, diy_fp b)
+{
+    const unsigned long long mask32 = 0xFFFFFFFFULL;
+    unsigned long long ah = a.f >> 32, al = a.f & mask32;
+    unsigned long long bh = b.f >> 32, bl = b.f & mask32;
+    unsigned long long hh = ah * bh, lh = al * bh, hl = ah * bl, ll = al * bl;
+    unsigned long long middle = (ll >> 32) + (hl & mask32) + (lh & mask32) + (1ULL << 31);
+
+    return diy_fp_make(hh + (hl >> 32) + (lh >> 32) + (middle >> 32), a.e + b.e + 64);
+}
+
+static diy_fp diy_fp_normalize(diy_fp value)
+{
+    while ((value.f & (1ULL << 63)) == 0)
+    {
+        value.f <<= 1;
+        value.e--;
+    }
+    return value;
+}
+
+/* the boundaries of the rounding interval of v, normalized to a common exponent */
+static void diy_fp_boundaries(diy_fp v, diy_fp *minus, diy_fp *plus)
+{
+    diy_fp upper = diy_fp_make((v.f << 1) + 1, v.e - 1);
+    diy_fp lower;
+
+    while ((upper.f & (dp_hidden_bit << 1)) == 0)
+    {
+        upper.f <<= 1;
+        upper.e--;
+    }
+    upper.f <<= (64 - 52 - 2);
+    upper.e -= (64 - 52 - 2);
+
+    /* the gap below a power of two is half as wide */
+    if (v.f == dp_hidden_bit)
+    {
+        lower = diy_fp_make((v.f << 2) - 1, v.e - 2);
+    }
+    else
+    {
+        lower = diy_fp_make((v.f << 1) - 1, v.e - 1);
+    }
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+
+    *minus = lower;
+    *plus = upper;
+}
+
+static int count_decimal_digits(unsigned int n)
+{
+    int digits = 1;
+    while ((digits < 10) && (n >= (unsigned int)powers_of_ten[digits]))
+    {
+        digits++;
+    }
+    return digits;
+}
+
+static void grisu_round(unsigned char *buffer, int length, unsigned long long delta, unsigned long long rest, unsigned long long ten_kappa, unsigned long long distance)
+{
+    while ((rest < distance) && ((delta - rest) >= ten_kappa)
+           && (((rest + ten_kappa) < distance) || ((distance - rest) > (rest + ten_kappa - distance))))
+    {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int grisu_digits(diy_fp w, diy_fp upper, unsigned long long delta, unsigned char *buffer, int *k)
+{
+    const diy_fp one = diy_fp_make(1ULL << -upper.e, upper.e);
+    const unsigned long long distance = upper.f - w.f;
+    unsigned int integral = (unsigned int)(upper.f >> -one.e);
+    unsigned long long fraction = upper.f & (one.f - 1);
+    int kappa = count_decimal_digits(integral);
+    int length = 0;
+
+    while (kappa > 0)
+    {
+        unsigned long long rest = 0;
+        unsigned int divisor = (unsigned int)powers_of_ten[kappa - 1];
+        unsigned int digit = integral / divisor;
+        integral %= divisor;
+        if ((digit != 0) || (length != 0))
+        {
+            buffer[length++] = (unsigned char)('0' + digit);
+        }
+        kappa--;
+        rest = ((unsigned long long)integral << -one.e) + fraction;
+        if (rest <= delta)
+        {
+            *k += kappa;
+            grisu_round(buffer, length, delta, rest, powers_of_ten[kappa] << -one.e, distance);
+            return length;
+        }
+    }
+
+    for (;;)
+    {
+        unsigned int digit = 0;
+        fraction *= 10;
+        delta *= 10;
+        digit = (unsigned int)(fraction >> -one.e);
+        if ((digit != 0) || (length != 0))
+        {
+            buffer[length++] = (unsigned char)('0' + digit);
+        }
+        fraction &= one.f - 1;
+        kappa--;
+        if (fraction < delta)
+        {
+            *k += kappa;
+            grisu_round(buffer, length, delta, fraction, one.f, distance * ((-kappa < 20) ? powers_of_ten[-kappa] : 0));
+            return length;
+        }
+    }
+}
+
+/* digits of a finite positive double, value == digits * 10^k */
+static int grisu2(double value, unsigned char *buffer, int *k)
+{
+    unsigned long long bits = 0;
+    int biased_exponent = 0;
+    diy_fp v, w, minus, plus, cached;
+    double cached_k = 0;
+    int cached_index = 0;
+
+    memcpy(&bits, &value, sizeof(bits));
+    biased_exponent = (int)((bits >> 52) & 0x7FF);
+    if (biased_exponent != 0)
+    {
+        v = diy_fp_make((bits & dp_significand_mask) + dp_hidden_bit, biased_exponent - dp_exponent_bias);
+    }
+    else
+    {
+        /* subnormal */
+        v = diy_fp_make(bits & dp_significand_mask, 1 - dp_exponent_bias);
+    }
+    diy_fp_boundaries(v, &minus, &plus);
+
+    /* pick the cached power of ten that brings plus.e into [-60, -32] */
+    cached_k = (-61 - plus.e) * 0.30102999566398114 + 347;
+    cached_index = (int)cached_k;
+    if ((cached_k - cached_index) > 0.0)
+    {
+        cached_index++;
+    }
+    cached_index = (cached_index >> 3) + 1;
+    *k = -(-348 + (cached_index << 3));
+    cached = diy_fp_make(cached_powers_f[cached_index], cached_powers_e[cached_index]);
+
+    w = diy_fp_multiply(diy_fp_normalize(v), cached);
+    plus = diy_fp_multiply(plus, cached);
+    minus = diy_fp_multiply(minus, cached);
+    minus.f++;
+    plus.f--;
+
+    return grisu_digits(w, plus, plus.f - minus.f, buffer, k);
+}
+
+static int write_exponent(int exponent, unsigned char *buffer)
+{
+    int length = 0;
+    buffer[length++] = 'e';
+    if (exponent < 0)
+    {
+        buffer[length++] = '-';
+        exponent = -exponent;
+    }
+    else
+    {
+        buffer[length++] = '+';
+    }
+    if (exponent >= 100)
+    {
+        buffer[length++] = (unsigned char)('0' + exponent / 100);
+        exponent %= 100;
+        buffer[length++] = (unsigned char)('0' + exponent / 10);
+    }
+    else if (exponent >= 10)
+    {
+        buffer[length++] = (unsigned char)('0' + exponent / 10);
+    }
+    buffer[length++] = (unsigned char)('0' + exponent % 10);
+    return length;
+}
+
+/* Lay out digits * 10^k in plain or exponential notation, returns the new length */
+static int format_digits(unsigned char *buffer, int length, int k)
+{
+    const int point = length + k; /* 10^(point-1) <= v < 10^point */
+    int i = 0;
+
+    if ((k >= 0) && (point <= 21))
+    {
+        /* 1234e7 -> 12340000000 */
+        for (i = length; i < point; i++)
+        {
+            buffer[i] = '0';
+        }
+        return point;
+    }
+    if ((point > 0) && (point <= 21))
+    {
+        /* 1234e-2 -> 12.34 */
+        memmove(buffer + point + 1, buffer + point, (size_t)(length - point));
+        buffer[point] = '.';
+        return length + 1;
+    }
+    if ((point > -6) && (point <= 0))
+    {
+        /* 1234e-6 -> 0.001234 */
+        const int offset = 2 - point;
+        memmove(buffer + offset, buffer, (size_t)length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for (i = 2; i < offset; i++)
+        {
+            buffer[i] = '0';
+        }
+        return length + offset;
+    }
+    if (length == 1)
+    {
+        /* 1e30 */
+        return 1 + write_exponent(point - 1, buffer + 1);
+    }
+    /* 1234e30 -> 1.234e+33 */
+    memmove(buffer + 2, buffer + 1, (size_t)(length - 1));
+    buffer[1] = '.';
+    return length + 1 + write_exponent(point - 1, buffer + length + 1);
+}
+
+/* two digits at a time, avoids half of the divisions */
+static const char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static int format_integer(int value, unsigned char *buffer)
+{
+    unsigned char digits[10];
+    unsigned int magnitude = (value < 0) ? (0U - (unsigned int)value) : (unsigned int)value;
+    int count = 0;
+    int length = 0;
+
+    while (magnitude >= 100)
+    {
+        unsigned int pair = (magnitude % 100) * 2;
+        magnitude /= 100;
+        digits[count++] = (unsigned char)digit_pairs[pair + 1];
+        digits[count++] = (unsigned char)digit_pairs[pair];
+    }
+    if (magnitude >= 10)
+    {
+        digits[count++] = (unsigned char)digit_pairs[magnitude * 2 + 1];
+        digits[count++] = (unsigned char)digit_pairs[magnitude * 2];
+    }
+    else
+    {
+        digits[count++] = (unsigned char)('0' + magnitude);
+    }
+
+    if (value < 0)
+    {
+        buffer[length++] = '-';
+    }
+    while (count > 0)
+    {
+        buffer[length++] = digits[--count];
+    }
+    buffer[length] = '\0';
+
+    return length;
+}
+
+static int format_double(double value, unsigned char *buffer)
+{
+    int length = 0;
+    int k = 0;
+
+    if (value < 0)
+    {
+        buffer[length++] = '-';
+        value = -value;
+    }
+    if (value == 0)
+    {
+        buffer[length++] = '0';
+    }
+    else
+    {
+        int digits = grisu2(value, buffer + length, &k);
+        length += format_digits(buffer + length, digits, k);
+    }
+    buffer[length] = '\0';
+
+    return length;
+}
+
 /* Render the number nicely from the given item into a string. */
 static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
 {
     unsigned char *output_pointer = NULL;
     double d = item->valuedouble;
     int length = 0;
-    size_t i = 0;
     unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = get_decimal_point();
-    double test = 0.0;
 
     if (output_buffer == NULL)
     {
@@ -606,26 +1144,21 @@ static cJSON_bool print_number(const cJSON * const item, printbuffer * const out
     /* This checks for NaN and Infinity */
     if (isnan(d) || isinf(d))
     {
-        length = sprintf((char*)number_buffer, "null");
+        memcpy(number_buffer, "null", sizeof("null"));
+        length = (int)sizeof("null") - 1;
     }
     else if(d == (double)item->valueint)
     {
-        length = sprintf((char*)number_buffer, "%d", item->valueint);
+        /* coordinates, timestamps, battery levels: by far the common case */
+        length = format_integer(item->valueint, number_buffer);
     }
     else
     {
-        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
-        length = sprintf((char*)number_buffer, "%1.15g", d);
-
-        /* Check whether the original double can be recovered */
-        if ((sscanf((char*)number_buffer, "%lg", &test) != 1) || !compare_double((double)test, d))
-        {
-            /* If not, print with 17 decimal places of precision */
-            length = sprintf((char*)number_buffer, "%1.17g", d);
-        }
+        /* shortest digits that round-trip; always '.' regardless of locale */
+        length = format_double(d, number_buffer);
     }
 
-    /* sprintf failed or buffer overrun occurred */
+    /* buffer overrun occurred */
     if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
     {
         return false;
@@ -638,19 +1171,8 @@ static cJSON_bool print_number(const cJSON * const item, printbuffer * const out
         return false;
     }
 
-    /* copy the printed number to the output and replace locale
-     * dependent decimal point with '.' */
-    for (i = 0; i < ((size_t)length); i++)
-    {
-        if (number_buffer[i] == decimal_point)
-        {
-            output_pointer[i] = '.';
-            continue;
-        }
-
-        output_pointer[i] = number_buffer[i];
-    }
-    output_pointer[i] = '\0';
+    /* copy the printed number to the output */
+    memcpy(output_pointer, number_buffer, (size_t)length + 1);
 
     output_buffer->offset += (size_t)length;
 
@@ -822,6 +1344,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
     unsigned char *output_pointer = NULL;
     unsigned char *output = NULL;
+    size_t skipped_bytes = 0;
 
     /* not a string */
     if (buffer_at_offset(input_buffer)[0] != '\"')
@@ -832,25 +1355,28 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     {
         /* calculate approximate size of the output (overestimate) */
         size_t allocation_length = 0;
-        size_t skipped_bytes = 0;
-        while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
+        const unsigned char *content_end = input_buffer->content + input_buffer->length;
+        for (;;)
         {
+            /* jump straight to the next quote or escape sequence */
+            input_end = scan_for_bytes(input_end, content_end, '\"', '\\');
+            if (input_end >= content_end)
+            {
+                goto fail; /* string ended unexpectedly */
+            }
+            if (input_end[0] == '\"')
+            {
+                break;
+            }
+
             /* is escape sequence */
-            if (input_end[0] == '\\')
+            if ((input_end + 1) >= content_end)
             {
-                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
-                {
-                    /* prevent buffer overflow when last input character is a backslash */
-                    goto fail;
-                }
-                skipped_bytes++;
-                input_end++;
+                /* prevent buffer overflow when last input character is a backslash */
+                goto fail;
             }
-            input_end++;
-        }
-        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
-        {
-            goto fail; /* string ended unexpectedly */
+            skipped_bytes++;
+            input_end += 2;
         }
 
         /* This is at most how much we need for the output */
@@ -863,12 +1389,24 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     }
 
     output_pointer = output;
+    if (skipped_bytes == 0)
+    {
+        /* no escape sequences, the literal is the value */
+        memcpy(output_pointer, input_pointer, (size_t)(input_end - input_pointer));
+        output_pointer += input_end - input_pointer;
+        input_pointer = input_end;
+    }
     /* loop through the string literal */
     while (input_pointer < input_end)
     {
         if (*input_pointer != '\\')
         {
-            *output_pointer++ = *input_pointer++;
+            /* copy the whole run up to the next escape sequence at once */
+            const unsigned char *run_end = scan_for_bytes(input_pointer, input_end, '\\', '\\');
+            size_t run_length = (size_t)(run_end - input_pointer);
+            memcpy(output_pointer, input_pointer, run_length);
+            output_pointer += run_length;
+            input_pointer = run_end;
         }
         /* escape sequence */
         else
@@ -1094,10 +1632,7 @@ static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
         return buffer;
     }
 
-    while (can_access_at_index(buffer, 0) && (buffer_at_offset(buffer)[0] <= 32))
-    {
-       buffer->offset++;
-    }
+    buffer->offset = (size_t)(scan_past_whitespace(buffer_at_offset(buffer), buffer->content + buffer->length) - buffer->content);
 
     if (buffer->offset == buffer->length)
     {
@@ -1359,6 +1894,70 @@ CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, cons
     return print_value(item, &p);
 }
 
+CJSON_PUBLIC(size_t) cJSON_PrintReusable(const cJSON *item, char **buffer, size_t *capacity, const cJSON_bool format, const char *suffix)
+{
+    static const size_t default_buffer_size = 256;
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    unsigned char *output_pointer = NULL;
+    size_t suffix_length = 0;
+
+    if ((buffer == NULL) || (capacity == NULL))
+    {
+        return 0;
+    }
+
+    if ((*buffer == NULL) || (*capacity == 0))
+    {
+        if (*buffer != NULL)
+        {
+            global_hooks.deallocate(*buffer);
+        }
+        *buffer = (char*)global_hooks.allocate(default_buffer_size);
+        *capacity = (*buffer != NULL) ? default_buffer_size : 0;
+        if (*buffer == NULL)
+        {
+            return 0;
+        }
+    }
+
+    p.buffer = (unsigned char*)*buffer;
+    p.length = *capacity;
+    p.offset = 0;
+    p.noalloc = false;
+    p.format = format;
+    p.hooks = global_hooks;
+
+    if (!print_value(item, &p))
+    {
+        goto fail;
+    }
+    update_offset(&p);
+
+    if (suffix != NULL)
+    {
+        suffix_length = strlen(suffix);
+        output_pointer = ensure(&p, suffix_length + 1);
+        if (output_pointer == NULL)
+        {
+            goto fail;
+        }
+        memcpy(output_pointer, suffix, suffix_length + 1);
+        p.offset += suffix_length;
+    }
+
+    *buffer = (char*)p.buffer;
+    *capacity = p.length;
+
+    return p.offset;
+
+fail:
+    /* ensure() releases the buffer when growing it fails, don't leave the caller dangling */
+    *buffer = (char*)p.buffer;
+    *capacity = (p.buffer != NULL) ? p.length : 0;
+
+    return 0;
+}
+
 /* Parser core - when encountering text, process appropriately. */
 static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer)
 {
@@ -158,6 +158,9 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_len
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Find the end of a newline delimited frame: returns a pointer to the first '\n' in buffer[0..length), or NULL if the frame is still incomplete. */
+CJSON_PUBLIC(const char *) cJSON_FindFrameEnd(const char *buffer, size_t length);
+
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. */
@@ -167,6 +170,10 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 /* Render a cJSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
 /* NOTE: cJSON is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format);
+/* Render a cJSON entity into a caller-owned buffer that is reused across calls. *buffer (may start as NULL) holds *capacity bytes and is grown
+ * with the cJSON hooks when too small, so steady-state printing does not allocate. suffix (may be NULL) is appended, e.g. a frame delimiter.
+ * Returns the length of the text (excluding the terminating '\0'), or 0 on failure. Release the buffer with cJSON_free. */
+CJSON_PUBLIC(size_t) cJSON_PrintReusable(const cJSON *item, char **buffer, size_t *capacity, const cJSON_bool format, const char *suffix);
 /* Delete a cJSON entity and all subentities. */
 CJSON_PUBLIC(void) cJSON_Delete(cJSON *item);
 
@@ -10,10 +10,22 @@
 #include <signal.h>
 #include <pthread.h>
 #include "cJSON/cJSON.h"
+#include "headers/protocol.h"
+#include "headers/log.h"
+#include "headers/loadgen.h"
+#include "headers/simclock.h"
 
 #define SERVER_IP "127.0.0.1"
 #define SERVER_PORT 2100
-#define BUFFER_SIZE 2048
+
+// Reconnect after a lost connection: the delay doubles from the base up to
+// the cap, each attempt waits a random 50-100% of it, and the drone gives
+// up after RECONNECT_GIVE_UP seconds. The server keeps the drone record for
+// RECONNECT_GRACE (25 s), so the first attempts land inside it.
+#define RECONNECT_BASE_MS 500
+#define RECONNECT_MAX_MS 8000
+#define RECONNECT_GIVE_UP 120
+#define HANDSHAKE_TIMEOUT 5     // seconds to wait for HANDSHAKE_ACK
 
 // Drone state structure
 typedef struct {
@@ -26,30 +38,24 @@ typedef struct {
     int battery;
     int speed;
     int on_mission;
+    int abort_mission;      // the server no longer knows the mission in flight
+    char mission_id[16];
+    char pending_complete[16];  // mission finished while disconnected: MISSION_COMPLETE still owed
+    char session_id[40];    // from HANDSHAKE_ACK, presented again on reconnect
+    int status_interval;    // seconds between position reports, from HANDSHAKE_ACK; 0 = every cell
     pthread_mutex_t lock;
     pthread_cond_t mission_cv;
+    FrameReader reader;     // inbound frames, shared by main and communication_thread
 } DroneState;
 
 DroneState* drone_state;
 
-void send_json(int sockfd, cJSON *json) {
-    char *data = cJSON_PrintUnformatted(json);
-    send(sockfd, data, strlen(data), 0);
-    send(sockfd, "\n", 1, 0);
-    free(data);
-}
-
-cJSON* recv_json(int sockfd, char *buffer, size_t buflen) {
-    ssize_t len = recv(sockfd, buffer, buflen - 1, 0);
-    if (len <= 0) return NULL;
-    buffer[len] = '\0';
-    return cJSON_Parse(buffer);
-}
-
-void handshake(int sockfd, const char* drone_id) {
+void handshake(int sockfd, const char* drone_id, const char* session_id) {
     cJSON *msg = cJSON_CreateObject();
     cJSON_AddStringToObject(msg, "type", "HANDSHAKE");
     cJSON_AddStringToObject(msg, "drone_id", drone_id);
+    // Resume an earlier session instead of registering anew
+    if (session_id && session_id[0]) cJSON_AddStringToObject(msg, "session_id", session_id);
     cJSON *cap = cJSON_CreateObject();
     cJSON_AddNumberToObject(cap, "max_speed", 30);
     cJSON_AddNumberToObject(cap, "battery_capacity", 100);
@@ -63,7 +69,7 @@ void status_update(int sockfd, const char* drone_id, int x, int y, const char* s
     cJSON *msg = cJSON_CreateObject();
     cJSON_AddStringToObject(msg, "type", "STATUS_UPDATE");
     cJSON_AddStringToObject(msg, "drone_id", drone_id);
-    cJSON_AddNumberToObject(msg, "timestamp", (int)time(NULL));
+    cJSON_AddNumberToObject(msg, "timestamp", (int)simclock_now());
     cJSON *loc = cJSON_CreateObject();
     cJSON_AddNumberToObject(loc, "x", x);
     cJSON_AddNumberToObject(loc, "y", y);
@@ -75,99 +81,233 @@ void status_update(int sockfd, const char* drone_id, int x, int y, const char* s
     cJSON_Delete(msg);
 }
 
-void mission_complete(int sockfd, const char* drone_id, const char* mission_id) {
+int mission_complete(int sockfd, const char* drone_id, const char* mission_id) {
     cJSON *msg = cJSON_CreateObject();
     cJSON_AddStringToObject(msg, "type", "MISSION_COMPLETE");
     cJSON_AddStringToObject(msg, "drone_id", drone_id);
     cJSON_AddStringToObject(msg, "mission_id", mission_id);
-    cJSON_AddNumberToObject(msg, "timestamp", (int)time(NULL));
+    cJSON_AddNumberToObject(msg, "timestamp", (int)simclock_now());
     cJSON_AddBoolToObject(msg, "success", 1);
     cJSON_AddStringToObject(msg, "details", "Delivered aid to survivor.");
-    send_json(sockfd, msg);
+    int rc = send_json(sockfd, msg);
     cJSON_Delete(msg);
+    return rc;
+}
+
+// Position reports while flying go out every status_interval (simulated)
+// seconds; status changes are reported at once by the caller.
+// Caller holds state->lock.
+static void report_position(DroneState *state, time_t *last_report) {
+    time_t now = simclock_now();
+    if (state->status_interval > 0 && now - *last_report < state->status_interval) return;
+    status_update(state->sockfd, state->drone_id, state->x, state->y, "busy", state->battery, state->speed);
+    *last_report = now;
+    log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Sent STATUS_UPDATE (busy). New pos: (%d,%d)\n", state->drone_id, state->x, state->y);
 }
 
 void* movement_thread(void* arg) {
     DroneState* state = (DroneState*)arg;
-    printf("[DRONE %s] movement_thread: Entered\n", state->drone_id); // Debug entry
+    log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Entered\n", state->drone_id); // Debug entry
 
     while (1) {
         pthread_mutex_lock(&state->lock);
-        printf("[DRONE %s] movement_thread: Waiting for mission (on_mission=%d)\n", state->drone_id, state->on_mission); // Debug wait
+        log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Waiting for mission (on_mission=%d)\n", state->drone_id, state->on_mission); // Debug wait
         while (!state->on_mission) {
             pthread_cond_wait(&state->mission_cv, &state->lock);
-             printf("[DRONE %s] movement_thread: Woke up from cond_wait (on_mission=%d)\n", state->drone_id, state->on_mission); // Debug wake up
+             log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Woke up from cond_wait (on_mission=%d)\n", state->drone_id, state->on_mission); // Debug wake up
         }
         
         // Store target coordinates
         int tx = state->target_x;
         int ty = state->target_y;
-        printf("[DRONE %s] movement_thread: Mission received! Target: (%d,%d). Current: (%d,%d)\n", state->drone_id, tx, ty, state->x, state->y); // Debug mission start
+        log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Mission received! Target: (%d,%d). Current: (%d,%d)\n", state->drone_id, tx, ty, state->x, state->y); // Debug mission start
+        // Idle -> busy is reported right away, then on the interval
+        status_update(state->sockfd, state->drone_id, state->x, state->y, "busy", state->battery, state->speed);
+        time_t last_report = simclock_now();
+        int aborted = 0;
         pthread_mutex_unlock(&state->lock);
 
         // Move along X axis first
         // printf("[DRONE %s] Movement thread: Starting X-axis movement to %d from %d\n", state->drone_id, tx, state->x); // Old log, can be removed
         while (1) {
             pthread_mutex_lock(&state->lock);
+            if (state->abort_mission) {
+                aborted = 1;
+                pthread_mutex_unlock(&state->lock);
+                break;
+            }
             if (state->x == tx) {
-                printf("[DRONE %s] movement_thread: X-axis movement complete. Current X: %d, Target X: %d\n", state->drone_id, state->x, tx); // Debug X complete
+                log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: X-axis movement complete. Current X: %d, Target X: %d\n", state->drone_id, state->x, tx); // Debug X complete
                 pthread_mutex_unlock(&state->lock);
                 break;
             }
             if (state->x < tx) state->x++; else state->x--;
             // printf("[DRONE %s] Movement thread: Moved to X=%d, Y=%d\n", state->drone_id, state->x, state->y); // Old log, can be removed
-            status_update(state->sockfd, state->drone_id, state->x, state->y, "busy", state->battery, state->speed);
-            printf("[DRONE %s] movement_thread: Sent STATUS_UPDATE (busy) for X-move. New pos: (%d,%d)\n", state->drone_id, state->x, state->y); // Debug status update
+            report_position(state, &last_report);
             pthread_mutex_unlock(&state->lock);
-            sleep(1);
+            simclock_sleep_ms(1000);   // one cell per simulated second
         }
 
         // Then move along Y axis
         // printf("[DRONE %s] Movement thread: Starting Y-axis movement to %d from %d\n", state->drone_id, ty, state->y); // Old log, can be removed
-        while (1) {
+        while (!aborted) {
             pthread_mutex_lock(&state->lock);
+            if (state->abort_mission) {
+                aborted = 1;
+                pthread_mutex_unlock(&state->lock);
+                break;
+            }
             if (state->y == ty) {
-                printf("[DRONE %s] movement_thread: Y-axis movement complete. Current Y: %d, Target Y: %d\n", state->drone_id, state->y, ty); // Debug Y complete
-                // Mission complete
-                mission_complete(state->sockfd, state->drone_id, "0");
-                printf("[DRONE %s] movement_thread: Sent MISSION_COMPLETE. Pos: (%d,%d)\n", state->drone_id, state->x, state->y); // Debug mission complete
+                log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Y-axis movement complete. Current Y: %d, Target Y: %d\n", state->drone_id, state->y, ty); // Debug Y complete
+                // Mission complete; offline, it goes out once the session is resumed
+                if (mission_complete(state->sockfd, state->drone_id, state->mission_id) < 0)
+                    snprintf(state->pending_complete, sizeof(state->pending_complete), "%s", state->mission_id);
+                log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Sent MISSION_COMPLETE. Pos: (%d,%d)\n", state->drone_id, state->x, state->y); // Debug mission complete
                 status_update(state->sockfd, state->drone_id, state->x, state->y, "idle", state->battery, state->speed);
-                printf("[DRONE %s] movement_thread: Sent STATUS_UPDATE (idle) after mission. Pos: (%d,%d)\n", state->drone_id, state->x, state->y); // Debug status idle
+                log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Sent STATUS_UPDATE (idle) after mission. Pos: (%d,%d)\n", state->drone_id, state->x, state->y); // Debug status idle
                 state->on_mission = 0;
                 pthread_mutex_unlock(&state->lock);
                 break;
             }
             if (state->y < ty) state->y++; else state->y--;
             // printf("[DRONE %s] Movement thread: Moved to X=%d, Y=%d\n", state->drone_id, state->x, state->y); // Old log, can be removed
-            status_update(state->sockfd, state->drone_id, state->x, state->y, "busy", state->battery, state->speed);
-            printf("[DRONE %s] movement_thread: Sent STATUS_UPDATE (busy) for Y-move. New pos: (%d,%d)\n", state->drone_id, state->x, state->y); // Debug status update
+            report_position(state, &last_report);
+            pthread_mutex_unlock(&state->lock);
+            simclock_sleep_ms(1000);   // one cell per simulated second
+        }
+        if (aborted) {
+            log_info(LOG_MOD_DRONE, "[DRONE %s] Mission abandoned, the server did not resume the session\n", state->drone_id);
+            pthread_mutex_lock(&state->lock);
+            state->abort_mission = 0;
+            state->on_mission = 0;
             pthread_mutex_unlock(&state->lock);
-            sleep(1);
         }
     }
-    printf("[DRONE %s] movement_thread: Exiting\n", state->drone_id); // Debug exit
+    log_debug(LOG_MOD_DRONE, "[DRONE %s] movement_thread: Exiting\n", state->drone_id); // Debug exit
     return NULL;
 }
 
+static int connect_to_server(void) {
+    struct sockaddr_in serv_addr;
+    memset(&serv_addr, 0, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(SERVER_PORT);
+    inet_pton(AF_INET, SERVER_IP, &serv_addr.sin_addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// HANDSHAKE on a fresh connection (resuming state->session_id if set) and
+// take the session and config from the ACK. Returns 1 if the server resumed
+// the session, 0 if it registered the drone anew, -1 on failure.
+static int register_drone(DroneState *state, int fd) {
+    frame_reader_init(&state->reader, fd);
+    struct timeval tv = { HANDSHAKE_TIMEOUT, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] Sending HANDSHAKE...\n");
+    handshake(fd, state->drone_id, state->session_id);
+    cJSON *msg = recv_json(&state->reader);
+    tv.tv_sec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (!msg) return -1;
+    char *resp_str = cJSON_PrintUnformatted(msg);
+    if (resp_str) {
+        printf("[DRONE] Server: %s\n", resp_str);
+        free(resp_str);
+    }
+    if (message_type_from_json(msg) == MSG_ERROR) {
+        // e.g. the server already has max_drones drones
+        cJSON_Delete(msg);
+        return -1;
+    }
+    cJSON *session = cJSON_GetObjectItem(msg, "session_id");
+    if (cJSON_IsString(session))
+        snprintf(state->session_id, sizeof(state->session_id), "%s", session->valuestring);
+    int resumed = cJSON_IsTrue(cJSON_GetObjectItem(msg, "resumed"));
+    // Report position at the cadence the server asks for
+    cJSON *cfg = cJSON_GetObjectItem(msg, "config");
+    cJSON *interval = cfg ? cJSON_GetObjectItem(cfg, "status_update_interval") : NULL;
+    if (cJSON_IsNumber(interval) && interval->valueint > 0) state->status_interval = interval->valueint;
+    cJSON_Delete(msg);
+    return resumed;
+}
+
+// Connection lost: reconnect with jittered exponential backoff and resume
+// the session, so the server keeps this drone's record and mission.
+static int reconnect(DroneState *state) {
+    pthread_mutex_lock(&state->lock);
+    close(state->sockfd);
+    state->sockfd = -1;     // status updates meanwhile fail quietly
+    pthread_mutex_unlock(&state->lock);
+    unsigned int seed = (unsigned int)time(NULL) ^ (unsigned int)getpid();
+    unsigned int backoff_ms = RECONNECT_BASE_MS;
+    time_t give_up = time(NULL) + RECONNECT_GIVE_UP;
+    for (int attempt = 1; time(NULL) < give_up; attempt++) {
+        unsigned int delay_ms = backoff_ms / 2 + (unsigned int)rand_r(&seed) % (backoff_ms / 2 + 1);
+        log_warn(LOG_MOD_DRONE, "[DRONE] Connection lost, reconnect attempt %d in %u ms\n", attempt, delay_ms);
+        usleep(delay_ms * 1000);
+        if (backoff_ms < RECONNECT_MAX_MS) backoff_ms *= 2;
+        int fd = connect_to_server();
+        if (fd < 0) continue;
+        int resumed = register_drone(state, fd);
+        if (resumed < 0) {
+            close(fd);
+            continue;
+        }
+        pthread_mutex_lock(&state->lock);
+        state->sockfd = fd;
+        // A new session means the mission in flight was given to someone else
+        if (!resumed && state->on_mission) state->abort_mission = 1;
+        // The server still has the drone on a mission we finished offline;
+        // "idle" alone would not end it
+        if (resumed && state->pending_complete[0])
+            mission_complete(fd, state->drone_id, state->pending_complete);
+        state->pending_complete[0] = '\0';
+        int busy = state->on_mission && !state->abort_mission;
+        status_update(fd, state->drone_id, state->x, state->y, busy ? "busy" : "idle", state->battery, state->speed);
+        pthread_mutex_unlock(&state->lock);
+        printf("[DRONE] Reconnected as %s, session %s\n", state->drone_id, resumed ? "resumed" : "new");
+        return 0;
+    }
+    return -1;
+}
+
 void* communication_thread(void* arg) {
     DroneState* state = (DroneState*)arg;
-    char buffer[BUFFER_SIZE];
-    time_t last_recv = time(NULL);
 
     while (1) {
-        cJSON *msg = recv_json(state->sockfd, buffer, sizeof(buffer));
-        if (!msg) {
-            sleep(1);
-            if (time(NULL) - last_recv >= 30) {
-                printf("[DRONE] No server response in 30 seconds, exiting\n");
+        size_t frame_len = 0;
+        char *frame = recv_frame(&state->reader, &frame_len);
+        if (!frame) {
+            if (reconnect(state) < 0) {
+                log_warn(LOG_MOD_DRONE, "[DRONE] Could not reconnect in %d seconds, exiting\n", RECONNECT_GIVE_UP);
                 exit(EXIT_SUCCESS);
             }
             continue;
         }
-        last_recv = time(NULL);
 
-        const char *type = cJSON_GetObjectItem(msg, "type")->valuestring;
-        if (strcmp(type, "ASSIGN_MISSION") == 0) {
+        MessageType type = sniff_message_type(frame, frame_len);
+        if (type == MSG_HEARTBEAT) {
+            // Respond to server heartbeat, echoing its send time for RTT; nothing else in it needs parsing
+            uint64_t sent_ns;
+            cJSON *resp = cJSON_CreateObject();
+            cJSON_AddStringToObject(resp, "type", "HEARTBEAT_RESPONSE");
+            cJSON_AddStringToObject(resp, "drone_id", state->drone_id);
+            cJSON_AddNumberToObject(resp, "timestamp", (int)simclock_now());
+            if (sniff_uint_field(frame, frame_len, "sent_ns", &sent_ns)) cJSON_AddNumberToObject(resp, "sent_ns", (double)sent_ns);
+            send_json(state->sockfd, resp);
+            cJSON_Delete(resp);
+            continue;
+        }
+        cJSON *msg = cJSON_ParseWithLength(frame, frame_len);
+        if (!msg) continue;
+        if (type == MSG_UNKNOWN) type = message_type_from_json(msg);
+        if (type == MSG_ASSIGN_MISSION) {
             // Parse target coordinates from nested object
             cJSON *tgt = cJSON_GetObjectItem(msg, "target");
             int tx = 0, ty = 0;
@@ -175,21 +315,15 @@ void* communication_thread(void* arg) {
                 tx = cJSON_GetObjectItem(tgt, "x")->valueint;
                 ty = cJSON_GetObjectItem(tgt, "y")->valueint;
             }
+            cJSON *mid = cJSON_GetObjectItem(msg, "mission_id");
             pthread_mutex_lock(&state->lock);
+            snprintf(state->mission_id, sizeof(state->mission_id), "%s", cJSON_IsString(mid) ? mid->valuestring : "0");
             state->target_x = tx;
             state->target_y = ty;
-            printf("[DRONE] Received ASSIGN_MISSION to (%d,%d)\n", tx, ty);
+            log_info(LOG_MOD_DRONE, "[DRONE] Received ASSIGN_MISSION to (%d,%d)\n", tx, ty);
             state->on_mission = 1;
             pthread_cond_signal(&state->mission_cv);
             pthread_mutex_unlock(&state->lock);
-        } else if (strcmp(type, "HEARTBEAT") == 0) {
-            // Respond to server heartbeat
-            cJSON *resp = cJSON_CreateObject();
-            cJSON_AddStringToObject(resp, "type", "HEARTBEAT_RESPONSE");
-            cJSON_AddStringToObject(resp, "drone_id", state->drone_id);
-            cJSON_AddNumberToObject(resp, "timestamp", (int)time(NULL));
-            send_json(state->sockfd, resp);
-            cJSON_Delete(resp);
         }
         cJSON_Delete(msg);
     }
@@ -197,8 +331,27 @@ void* communication_thread(void* arg) {
 }
 
 int main(int argc, char *argv[]) {
+    // --load: many simulated drones in this one process
+    if (argc > 1 && strcmp(argv[1], "--load") == 0) return loadgen_main(argc - 1, argv + 1);
     signal(SIGPIPE, SIG_IGN);
-    const char* drone_id = argc > 1 ? argv[1] : "D1";
+    log_init();
+    // --time-scale N runs simulated time N times faster than the wall clock,
+    // --virtual-clock never sleeps at all
+    double time_scale = 1.0;
+    int virtual_clock = 0;
+    int arg = 1;
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+        if (strcmp(argv[arg], "--time-scale") == 0 && arg + 1 < argc && atof(argv[arg + 1]) > 0) {
+            time_scale = atof(argv[++arg]);
+        } else if (strcmp(argv[arg], "--virtual-clock") == 0) {
+            virtual_clock = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--time-scale N] [--virtual-clock] [drone_id]\n       %s --load ...\n", argv[0], argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    simclock_init(time_scale, virtual_clock);
+    const char* drone_id = arg < argc ? argv[arg] : "D1";
 
     // Initialize drone state
     drone_state = malloc(sizeof(DroneState));
@@ -208,58 +361,42 @@ int main(int argc, char *argv[]) {
     drone_state->battery = 100;
     drone_state->speed = 1;
     drone_state->on_mission = 0;
+    drone_state->abort_mission = 0;
+    drone_state->mission_id[0] = '\0';
+    drone_state->pending_complete[0] = '\0';
+    drone_state->session_id[0] = '\0';
+    drone_state->status_interval = 0;
     pthread_mutex_init(&drone_state->lock, NULL);
     pthread_cond_init(&drone_state->mission_cv, NULL);
 
     // Connect to server
-    struct sockaddr_in serv_addr;
-    drone_state->sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (drone_state->sockfd < 0) { perror("socket"); exit(EXIT_FAILURE); }
-    
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port = htons(SERVER_PORT);
-    inet_pton(AF_INET, SERVER_IP, &serv_addr.sin_addr);
-    
-    if (connect(drone_state->sockfd, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
-        perror("connect"); exit(EXIT_FAILURE);
-    }
+    drone_state->sockfd = connect_to_server();
+    if (drone_state->sockfd < 0) { perror("connect"); exit(EXIT_FAILURE); }
     
     printf("[DRONE] Connected to server as %s\n", drone_id);
     
     // Initial handshake
-    printf("[DRONE-DEBUG] Sending HANDSHAKE...\n");
-    handshake(drone_state->sockfd, drone_id);
-    printf("[DRONE-DEBUG] HANDSHAKE sent, awaiting ACK...\n");
-    char buffer[BUFFER_SIZE];
-    cJSON *msg = recv_json(drone_state->sockfd, buffer, sizeof(buffer));
-    printf("[DRONE-DEBUG] recv_json returned %p\n", (void*)msg);
-    if (msg) {
-        char *resp_str = cJSON_PrintUnformatted(msg);
-        if (resp_str) {
-            printf("[DRONE] Server: %s\n", resp_str);
-            free(resp_str);
-        }
-        cJSON_Delete(msg);
-    }
-    printf("[DRONE-DEBUG] After processing HANDSHAKE_ACK\n");
+    if (register_drone(drone_state, drone_state->sockfd) < 0)
+        log_warn(LOG_MOD_DRONE, "[DRONE] No HANDSHAKE_ACK from server\n");
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] After processing HANDSHAKE_ACK\n");
 
     // Send initial status
-    printf("[DRONE-DEBUG] Sending initial STATUS_UPDATE...\n");
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] Sending initial STATUS_UPDATE...\n");
     status_update(drone_state->sockfd, drone_id, 0, 0, "idle", 100, 1);
-    printf("[DRONE-DEBUG] STATUS_UPDATE sent\n");
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] STATUS_UPDATE sent\n");
 
     // Create movement and communication threads
-    printf("[DRONE-DEBUG] Creating threads\n");
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] Creating threads\n");
     pthread_t move_tid, comm_tid;
     int ret1 = pthread_create(&move_tid, NULL, movement_thread, drone_state);
     int ret2 = pthread_create(&comm_tid, NULL, communication_thread, drone_state);
-    printf("[DRONE-DEBUG] Threads created: %d, %d\n", ret1, ret2);
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] Threads created: %d, %d\n", ret1, ret2);
     pthread_join(move_tid, NULL);
     pthread_join(comm_tid, NULL);
-    printf("[DRONE-DEBUG] Threads joined\n");
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] Threads joined\n");
 
     // Cleanup
-    printf("[DRONE-DEBUG] Cleaning up and exiting\n");
+    log_debug(LOG_MOD_DRONE, "[DRONE-DEBUG] Cleaning up and exiting\n");
     close(drone_state->sockfd);
     pthread_mutex_destroy(&drone_state->lock);
     pthread_cond_destroy(&drone_state->mission_cv);
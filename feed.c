@@ -0,0 +1,342 @@
+// State feed: snapshots the world on its own thread, diffs consecutive
+// copies by id and streams the changes to subscribers over non-blocking
+// sockets driven by poll().
+#include "headers/feed.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "headers/snapshot.h"
+#include "headers/globals.h"
+#include "headers/timer.h"
+#include "headers/metrics.h"
+#include "headers/log.h"
+
+typedef struct {
+    uint8_t *data;
+    size_t len, capacity;
+} FeedBuffer;
+
+typedef struct {
+    int fd;                 // -1 when the slot is free
+    int synced;             // has had the full snapshot
+    FeedBuffer out;
+    size_t sent;
+} Subscriber;
+
+static int feed_sock = -1;
+static Subscriber subscribers[FEED_MAX_SUBSCRIBERS];
+static int subscriber_count;
+
+// Previous and current copy of the world, sorted by id
+static WorldSnapshot copies[2];
+static WorldSnapshot *previous = &copies[0], *current = &copies[1];
+static int previous_valid;
+static uint64_t feed_seq;
+
+static FeedBuffer delta, full;
+
+static uint8_t *feed_reserve(FeedBuffer *b, size_t n) {
+    if (b->len + n > b->capacity) {
+        size_t capacity = b->capacity ? b->capacity * 2 : 4096;
+        while (capacity < b->len + n) capacity *= 2;
+        uint8_t *data = realloc(b->data, capacity);
+        if (!data) return NULL;
+        b->data = data;
+        b->capacity = capacity;
+    }
+    uint8_t *p = b->data + b->len;
+    b->len += n;
+    return p;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) *p++ = (uint8_t)(v >> (8 * i));
+    return p;
+}
+
+static uint8_t *put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) *p++ = (uint8_t)(v >> (8 * i));
+    return p;
+}
+
+static void put_hello(FeedBuffer *b, const WorldSnapshot *snap) {
+    uint8_t *p = feed_reserve(b, FEED_HELLO_SIZE);
+    if (!p) return;
+    *p++ = FEED_HELLO;
+    *p++ = FEED_VERSION;
+    p = put_u32(p, (uint32_t)snap->map_width);
+    put_u32(p, (uint32_t)snap->map_height);
+}
+
+static void put_drone(FeedBuffer *b, const SnapshotDrone *d) {
+    uint8_t *p = feed_reserve(b, FEED_DRONE_SIZE);
+    if (!p) return;
+    *p++ = FEED_DRONE;
+    p = put_u32(p, (uint32_t)d->id);
+    *p++ = (uint8_t)d->status;
+    p = put_u32(p, (uint32_t)d->coord.x);
+    p = put_u32(p, (uint32_t)d->coord.y);
+    p = put_u32(p, (uint32_t)d->target.x);
+    put_u32(p, (uint32_t)d->target.y);
+}
+
+static void put_survivor(FeedBuffer *b, const SnapshotSurvivor *s) {
+    uint8_t *p = feed_reserve(b, FEED_SURVIVOR_SIZE);
+    if (!p) return;
+    *p++ = FEED_SURVIVOR;
+    p = put_u32(p, s->id);
+    *p++ = (uint8_t)s->kind;
+    p = put_u32(p, (uint32_t)s->coord.x);
+    put_u32(p, (uint32_t)s->coord.y);
+}
+
+static void put_gone(FeedBuffer *b, FeedRecordType type, uint32_t id) {
+    uint8_t *p = feed_reserve(b, FEED_GONE_SIZE);
+    if (!p) return;
+    *p++ = (uint8_t)type;
+    put_u32(p, id);
+}
+
+static void put_tick(FeedBuffer *b, const WorldSnapshot *snap) {
+    uint8_t *p = feed_reserve(b, FEED_TICK_SIZE);
+    if (!p) return;
+    *p++ = FEED_TICK;
+    p = put_u64(p, snap->seq);
+    put_u64(p, snap->taken_ns);
+}
+
+static int compare_drones(const void *a, const void *b) {
+    int x = ((const SnapshotDrone *)a)->id, y = ((const SnapshotDrone *)b)->id;
+    return (x > y) - (x < y);
+}
+
+// By id, and for equal ids the most advanced kind first
+static int compare_survivors(const void *a, const void *b) {
+    const SnapshotSurvivor *x = a, *y = b;
+    if (x->id != y->id) return (x->id > y->id) - (x->id < y->id);
+    return (x->kind < y->kind) - (x->kind > y->kind);
+}
+
+// Sort both lists by id for put_changes, which needs ids unique. Every move
+// between survivor lists holds priority_mutex, as snapshot_capture does, so
+// a survivor copied twice means a move that skipped it; keep its most
+// advanced kind.
+static void sort_snapshot(WorldSnapshot *snap) {
+    qsort(snap->drones, (size_t)snap->drone_count, sizeof(SnapshotDrone), compare_drones);
+    qsort(snap->survivors, (size_t)snap->survivor_count, sizeof(SnapshotSurvivor), compare_survivors);
+    int kept = 0;
+    for (int i = 0; i < snap->survivor_count; i++) {
+        if (kept && snap->survivors[kept - 1].id == snap->survivors[i].id) continue;
+        snap->survivors[kept++] = snap->survivors[i];
+    }
+    snap->survivor_count = kept;
+}
+
+static int same_drone(const SnapshotDrone *a, const SnapshotDrone *b) {
+    return a->status == b->status && a->coord.x == b->coord.x && a->coord.y == b->coord.y &&
+           a->target.x == b->target.x && a->target.y == b->target.y;
+}
+
+// Records that turn `from` into `to`; both sorted by id, ids unique
+static void put_changes(FeedBuffer *b, const WorldSnapshot *from, const WorldSnapshot *to) {
+    int i = 0, j = 0;
+    while (i < from->drone_count || j < to->drone_count) {
+        const SnapshotDrone *old = i < from->drone_count ? &from->drones[i] : NULL;
+        const SnapshotDrone *now = j < to->drone_count ? &to->drones[j] : NULL;
+        if (!now || (old && old->id < now->id)) {
+            put_gone(b, FEED_DRONE_GONE, (uint32_t)old->id);
+            i++;
+        } else if (!old || now->id < old->id) {
+            put_drone(b, now);
+            j++;
+        } else {
+            if (!same_drone(old, now)) put_drone(b, now);
+            i++;
+            j++;
+        }
+    }
+    i = j = 0;
+    while (i < from->survivor_count || j < to->survivor_count) {
+        const SnapshotSurvivor *old = i < from->survivor_count ? &from->survivors[i] : NULL;
+        const SnapshotSurvivor *now = j < to->survivor_count ? &to->survivors[j] : NULL;
+        if (!now || (old && old->id < now->id)) {
+            put_gone(b, FEED_SURVIVOR_GONE, old->id);
+            i++;
+        } else if (!old || now->id < old->id) {
+            put_survivor(b, now);
+            j++;
+        } else {
+            if (old->kind != now->kind) put_survivor(b, now);
+            i++;
+            j++;
+        }
+    }
+}
+
+static void drop_subscriber(Subscriber *s) {
+    close(s->fd);
+    s->fd = -1;
+    s->out.len = s->sent = 0;
+    subscriber_count--;
+    metrics_gauge_add(GAUGE_FEED_SUBSCRIBERS, -1);
+}
+
+static void flush_subscriber(Subscriber *s) {
+    while (s->sent < s->out.len) {
+        ssize_t n = send(s->fd, s->out.data + s->sent, s->out.len - s->sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            s->sent += (size_t)n;
+            metrics_add(CTR_FEED_BYTES, (uint64_t)n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            drop_subscriber(s);
+            return;
+        }
+    }
+    s->out.len = s->sent = 0;
+}
+
+static void queue(Subscriber *s, const FeedBuffer *b) {
+    if (s->out.len - s->sent + b->len > FEED_BACKLOG_MAX) {
+        log_warn(LOG_MOD_SERVER, "[FEED] Subscriber %d fell behind, disconnecting\n", s->fd);
+        drop_subscriber(s);
+        return;
+    }
+    uint8_t *p = feed_reserve(&s->out, b->len);
+    if (p) memcpy(p, b->data, b->len);
+    flush_subscriber(s);
+}
+
+static void feed_tick(void) {
+    snapshot_capture(current);
+    current->seq = ++feed_seq;
+    sort_snapshot(current);
+
+    delta.len = full.len = 0;
+    if (previous_valid) {
+        put_changes(&delta, previous, current);
+        put_tick(&delta, current);
+    }
+    for (int i = 0; i < FEED_MAX_SUBSCRIBERS; i++) {
+        Subscriber *s = &subscribers[i];
+        if (s->fd < 0) continue;
+        if (s->synced && previous_valid) {
+            queue(s, &delta);
+            continue;
+        }
+        if (!full.len) {
+            static const WorldSnapshot empty;
+            put_hello(&full, current);
+            put_changes(&full, &empty, current);
+            put_tick(&full, current);
+        }
+        s->synced = 1;
+        queue(s, &full);
+    }
+    WorldSnapshot *t = previous;
+    previous = current;
+    current = t;
+    previous_valid = 1;
+}
+
+static void accept_subscribers(void) {
+    for (;;) {
+        int fd = accept(feed_sock, NULL, NULL);
+        if (fd < 0) return;
+        Subscriber *slot = NULL;
+        for (int i = 0; i < FEED_MAX_SUBSCRIBERS && !slot; i++)
+            if (subscribers[i].fd < 0) slot = &subscribers[i];
+        if (!slot) {
+            close(fd);
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        slot->fd = fd;
+        slot->synced = 0;
+        subscriber_count++;
+        metrics_gauge_add(GAUGE_FEED_SUBSCRIBERS, 1);
+    }
+}
+
+static void *feed_thread(void *arg) {
+    struct pollfd fds[FEED_MAX_SUBSCRIBERS + 1];
+    Subscriber *owners[FEED_MAX_SUBSCRIBERS + 1];
+    uint64_t next_tick = monotonic_ns();
+    while (running) {
+        int n = 0;
+        fds[n++] = (struct pollfd){ feed_sock, POLLIN, 0 };
+        for (int i = 0; i < FEED_MAX_SUBSCRIBERS; i++) {
+            Subscriber *s = &subscribers[i];
+            if (s->fd < 0) continue;
+            owners[n] = s;
+            fds[n++] = (struct pollfd){ s->fd, (short)(POLLIN | (s->sent < s->out.len ? POLLOUT : 0)), 0 };
+        }
+        uint64_t now = monotonic_ns();
+        int timeout = next_tick > now ? (int)((next_tick - now) / 1000000) + 1 : 0;
+        if (poll(fds, (nfds_t)n, timeout) < 0 && errno != EINTR) {
+            perror("feed poll");
+            break;
+        }
+        for (int i = 1; i < n; i++) {
+            Subscriber *s = owners[i];
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                // Subscribers only listen; EOF or an error means they left
+                char discard[256];
+                ssize_t r = recv(s->fd, discard, sizeof(discard), 0);
+                if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    drop_subscriber(s);
+                    continue;
+                }
+            }
+            if (fds[i].revents & POLLOUT) flush_subscriber(s);
+        }
+        if (fds[0].revents & POLLIN) accept_subscribers();
+
+        now = monotonic_ns();
+        if (now < next_tick) continue;
+        next_tick += FEED_INTERVAL_MS * 1000000ull;
+        if (next_tick < now) next_tick = now + FEED_INTERVAL_MS * 1000000ull;
+        // Nobody listening: no copies, and the next subscriber starts fresh
+        if (subscriber_count) feed_tick();
+        else previous_valid = 0;
+    }
+    return NULL;
+}
+
+int feed_start(int port) {
+    for (int i = 0; i < FEED_MAX_SUBSCRIBERS; i++) subscribers[i].fd = -1;
+    feed_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (feed_sock < 0) return -1;
+    int one = 1;
+    setsockopt(feed_sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(feed_sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(feed_sock, FEED_MAX_SUBSCRIBERS) < 0) {
+        int err = errno;
+        close(feed_sock);
+        feed_sock = -1;
+        errno = err;
+        return -1;
+    }
+    fcntl(feed_sock, F_SETFL, fcntl(feed_sock, F_GETFL) | O_NONBLOCK);
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, feed_thread, NULL) != 0) {
+        close(feed_sock);
+        feed_sock = -1;
+        return -1;
+    }
+    pthread_detach(tid);
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Flight recorder ring shared by all threads. Writers claim a slot with one
+// atomic increment and publish it through the slot's sequence number; the
+// dumper skips slots that are being rewritten. The dump path uses only
+// async-signal-safe calls (no stdio, no malloc).
+#include "headers/flightrec.h"
+#include "headers/protocol.h"
+#include "headers/timer.h"
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+typedef struct {
+    uint64_t seq;               // index + 1 once written, 0 while being written
+    uint64_t ts_ns;
+    int32_t event;
+    int32_t args[3];
+} FlightEntry;
+
+typedef struct {
+    const char *name;
+    const char *labels[3];
+} FlightEventDesc;
+
+#define FLIGHT_EVENT_DESC(id, name, a, b, c) [id] = { name, { a, b, c } },
+static const FlightEventDesc event_desc[FLIGHT_EVENT_COUNT] = { FLIGHT_EVENTS(FLIGHT_EVENT_DESC) };
+#undef FLIGHT_EVENT_DESC
+
+static const char *message_names[] = {
+    [MSG_UNKNOWN] = "UNKNOWN",
+    [MSG_HANDSHAKE] = "HANDSHAKE",
+    [MSG_HANDSHAKE_ACK] = "HANDSHAKE_ACK",
+    [MSG_STATUS_UPDATE] = "STATUS_UPDATE",
+    [MSG_MISSION_COMPLETE] = "MISSION_COMPLETE",
+    [MSG_HEARTBEAT] = "HEARTBEAT",
+    [MSG_HEARTBEAT_RESPONSE] = "HEARTBEAT_RESPONSE",
+    [MSG_ASSIGN_MISSION] = "ASSIGN_MISSION",
+    [MSG_ERROR] = "ERROR",
+};
+
+static FlightEntry ring[FLIGHTREC_SIZE];
+static uint64_t next_index;
+static char dump_path[256];
+static volatile sig_atomic_t fatal_dumping;
+
+void flightrec_record(FlightEvent event, int a, int b, int c) {
+    uint64_t index = __atomic_fetch_add(&next_index, 1, __ATOMIC_RELAXED);
+    FlightEntry *e = &ring[index % FLIGHTREC_SIZE];
+    __atomic_store_n(&e->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    e->ts_ns = monotonic_ns();
+    e->event = event;
+    e->args[0] = a;
+    e->args[1] = b;
+    e->args[2] = c;
+    __atomic_store_n(&e->seq, index + 1, __ATOMIC_RELEASE);
+}
+
+// Line assembly without stdio
+typedef struct {
+    char data[256];
+    size_t len;
+} Line;
+
+static void put_str(Line *l, const char *s) {
+    while (*s && l->len < sizeof(l->data)) l->data[l->len++] = *s++;
+}
+
+static void put_uint(Line *l, uint64_t v, int min_digits) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v || n < min_digits);
+    while (n && l->len < sizeof(l->data)) l->data[l->len++] = digits[--n];
+}
+
+static void put_int(Line *l, int64_t v) {
+    if (v < 0) {
+        put_str(l, "-");
+        put_uint(l, (uint64_t)0 - (uint64_t)v, 1);
+    } else {
+        put_uint(l, (uint64_t)v, 1);
+    }
+}
+
+static void put_padded(Line *l, const char *s, size_t width) {
+    size_t start = l->len;
+    put_str(l, s);
+    while (l->len - start < width && l->len < sizeof(l->data)) l->data[l->len++] = ' ';
+}
+
+static void flush_line(int fd, Line *l) {
+    size_t off = 0;
+    while (off < l->len) {
+        ssize_t n = write(fd, l->data + off, l->len - off);
+        if (n <= 0) break;
+        off += (size_t)n;
+    }
+    l->len = 0;
+}
+
+void flightrec_dump(const char *reason) {
+    if (!dump_path[0]) return;
+    int fd = open(dump_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return;
+    uint64_t now = monotonic_ns();
+    uint64_t end = __atomic_load_n(&next_index, __ATOMIC_ACQUIRE);
+    uint64_t first = end > FLIGHTREC_SIZE ? end - FLIGHTREC_SIZE : 0;
+    Line l = { .len = 0 };
+    put_str(&l, "=== flight recorder: ");
+    put_str(&l, reason);
+    put_str(&l, ", pid ");
+    put_uint(&l, (uint64_t)getpid(), 1);
+    put_str(&l, ", unix time ");
+    put_uint(&l, (uint64_t)time(NULL), 1);
+    put_str(&l, ", events ");
+    put_uint(&l, first, 1);
+    put_str(&l, "..");
+    put_uint(&l, end, 1);
+    put_str(&l, " ===\n");
+    flush_line(fd, &l);
+    for (uint64_t i = first; i < end; i++) {
+        FlightEntry *e = &ring[i % FLIGHTREC_SIZE];
+        if (__atomic_load_n(&e->seq, __ATOMIC_ACQUIRE) != i + 1) continue;
+        FlightEntry copy = *e;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&e->seq, __ATOMIC_RELAXED) != i + 1) continue;   // rewritten meanwhile
+        if (copy.event < 0 || copy.event >= FLIGHT_EVENT_COUNT) continue;
+        // Age relative to the dump, in ms with microsecond resolution
+        uint64_t age_us = now > copy.ts_ns ? (now - copy.ts_ns) / 1000 : 0;
+        put_str(&l, "-");
+        put_uint(&l, age_us / 1000, 1);
+        put_str(&l, ".");
+        put_uint(&l, age_us % 1000, 3);
+        put_str(&l, " ms  ");
+        const FlightEventDesc *desc = &event_desc[copy.event];
+        put_padded(&l, desc->name, 17);
+        for (int a = 0; a < 3; a++) {
+            if (!desc->labels[a]) continue;
+            put_str(&l, " ");
+            put_str(&l, desc->labels[a]);
+            put_str(&l, "=");
+            if (copy.event == FR_RX && a == 1 && copy.args[a] >= 0 &&
+                copy.args[a] < (int)(sizeof(message_names) / sizeof(message_names[0]))) {
+                put_str(&l, message_names[copy.args[a]]);
+            } else {
+                put_int(&l, copy.args[a]);
+            }
+        }
+        put_str(&l, "\n");
+        flush_line(fd, &l);
+    }
+    close(fd);
+}
+
+static void on_signal(int sig) {
+    if (sig == SIGUSR2) {
+        flightrec_dump("SIGUSR2");
+        return;
+    }
+    // Crash: dump once, then let the default action end the process
+    if (!fatal_dumping) {
+        fatal_dumping = 1;
+        flightrec_dump(sig == SIGSEGV ? "SIGSEGV" : "SIGABRT");
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+int flightrec_install(const char *path) {
+    strncpy(dump_path, path, sizeof(dump_path) - 1);
+    dump_path[sizeof(dump_path) - 1] = '\0';
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if (sigaction(SIGSEGV, &sa, NULL) < 0 || sigaction(SIGABRT, &sa, NULL) < 0 ||
+        sigaction(SIGUSR2, &sa, NULL) < 0) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef ADMIN_HTTP_H
+#define ADMIN_HTTP_H
+
+#include <poll.h>
+
+// Minimal HTTP listener for monitoring, bound to localhost. It has no thread
+// of its own: the server's accept loop adds its sockets to poll() and
+// hands back the ready ones.
+//   GET /metrics   metrics registry in Prometheus text format
+//   GET /trace     mission lifecycle spans as a Chrome/Perfetto trace
+//   GET /frame.png the whole map rendered now (also /frame.ppm)
+
+// Returns 0 on success, -1 (with errno) if the port cannot be bound
+int admin_http_start(int port);
+// Room admin_http_fill_fds needs: listener, connections, frame notifier
+#define ADMIN_POLL_FDS 10
+
+// Add the listener and open connections to fds; returns how many it added
+int admin_http_fill_fds(struct pollfd *fds);
+// Accept, read requests and write responses for whatever poll() reported
+void admin_http_service(const struct pollfd *fds, int count);
+
+#endif // ADMIN_HTTP_H
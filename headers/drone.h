@@ -6,6 +6,8 @@
 #include <time.h>
 #include <pthread.h>
 #include "list.h"
+#include "timer.h"
+#include "histogram.h"
 
 typedef enum {
     IDLE,
@@ -14,6 +16,8 @@ typedef enum {
 } DroneStatus;
 
 
+#define SESSION_ID_LEN 16   // hex characters
+
 typedef struct drone {
     int id;
     int sockfd;    // client socket descriptor for sending missions
@@ -26,8 +30,15 @@ typedef struct drone {
     pthread_cond_t mission_cv;  // Condition variable for new missions
     volatile bool lock_initialized;    // Flag to track if mutex is initialized
     volatile bool cv_initialized;      // Flag to track if condition variable is initialized
-    time_t last_heartbeat;   // Timestamp of last heartbeat response
-    int missed_heartbeats;   // Consecutive missed heartbeat count
+    time_t last_seen;        // Timestamp of last valid inbound frame
+    int missed_heartbeats;   // HEARTBEATs sent since then
+    Timer liveness_timer;    // Fires after a heartbeat interval of silence
+    Timer reconnect_timer;   // Grace period after the socket drops
+    Timer mission_timer;     // ASSIGN_MISSION expiry
+    Histogram rtt;           // HEARTBEAT round trips, in ns
+    uint32_t mission_seq;    // number of the mission in flight (M<n>)
+    uint64_t mission_sent_ns;   // when its ASSIGN_MISSION went out
+    char session_id[SESSION_ID_LEN + 1];  // handed out in HANDSHAKE_ACK
 } Drone;
 
 // Global drone list (extern)
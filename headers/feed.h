@@ -0,0 +1,45 @@
+#ifndef FEED_H
+#define FEED_H
+
+// Binary state feed for external viewers and dashboards, on a localhost TCP
+// port. One thread of its own copies the world every FEED_INTERVAL_MS while
+// anyone is subscribed, diffs it against the previous copy and sends the
+// changes to every subscriber; the simulation threads are not involved.
+//
+// Wire format: fixed-size records, little-endian, the first byte is the type.
+//   FEED_HELLO          u8 type, u8 version, i32 map_width, i32 map_height
+//   FEED_DRONE          u8 type, i32 id, u8 status, i32 x, i32 y, i32 target_x, i32 target_y
+//   FEED_DRONE_GONE     u8 type, i32 id
+//   FEED_SURVIVOR       u8 type, u32 id, u8 kind, i32 x, i32 y
+//   FEED_SURVIVOR_GONE  u8 type, u32 id
+//   FEED_TICK           u8 type, u64 seq, u64 taken_ns
+// A new subscriber first gets HELLO, a DRONE/SURVIVOR record for everything
+// on the map and a TICK. After that each interval brings the DRONE/SURVIVOR
+// records that appeared or changed, GONE for the ones that left, and a TICK
+// closing the batch. status is DroneStatus, kind is SnapshotSurvivorKind.
+// Subscribers that fall FEED_BACKLOG_MAX bytes behind are disconnected.
+
+#define FEED_VERSION 1
+#define FEED_INTERVAL_MS 100
+#define FEED_MAX_SUBSCRIBERS 16
+#define FEED_BACKLOG_MAX (4 << 20)
+
+typedef enum {
+    FEED_HELLO = 'H',
+    FEED_DRONE = 'D',
+    FEED_DRONE_GONE = 'd',
+    FEED_SURVIVOR = 'S',
+    FEED_SURVIVOR_GONE = 's',
+    FEED_TICK = 'T'
+} FeedRecordType;
+
+#define FEED_HELLO_SIZE 10
+#define FEED_DRONE_SIZE 22
+#define FEED_GONE_SIZE 5
+#define FEED_SURVIVOR_SIZE 14
+#define FEED_TICK_SIZE 17
+
+// Listen on 127.0.0.1:port and start the feed thread; 0 or -1 (with errno)
+int feed_start(int port);
+
+#endif // FEED_H
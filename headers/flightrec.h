@@ -0,0 +1,42 @@
+#ifndef FLIGHTREC_H
+#define FLIGHTREC_H
+
+// Flight recorder: the last FLIGHTREC_SIZE protocol events and scheduler
+// decisions, always on, kept in a fixed ring in memory. It is dumped to a
+// file on SIGSEGV, SIGABRT, SIGUSR2 and at watchdog shutdown. Recording
+// takes no lock; the dump is async-signal-safe.
+
+#define FLIGHTREC_SIZE 4096
+
+// X(id, name, arg labels...); unused arguments have a NULL label
+#define FLIGHT_EVENTS(X) \
+    X(FR_CONNECT,          "connect",          "sock",   NULL,      NULL) \
+    X(FR_DISCONNECT,       "disconnect",       "sock",   NULL,      NULL) \
+    X(FR_RX,               "rx",               "sock",   "type",    "bytes") \
+    X(FR_MALFORMED,        "malformed",        "sock",   "bytes",   NULL) \
+    X(FR_HANDSHAKE,        "handshake",        "drone",  "sock",    NULL) \
+    X(FR_RESUME,           "resume",           "drone",  "sock",    "old_sock") \
+    X(FR_REJECTED,         "rejected",         "drone",  "sock",    NULL) \
+    X(FR_STATUS_UPDATE,    "status_update",    "drone",  "x",       "y") \
+    X(FR_MISSION_COMPLETE, "mission_complete", "drone",  "success", NULL) \
+    X(FR_HEARTBEAT_SENT,   "heartbeat_sent",   "drone",  "missed",  NULL) \
+    X(FR_HEARTBEAT_RTT,    "heartbeat_rtt",    "sock",   "us",      NULL) \
+    X(FR_DRONE_DROPPED,    "drone_dropped",    "drone",  NULL,      NULL) \
+    X(FR_ASSIGN,           "assign",           "drone",  "x",       "y") \
+    X(FR_NO_IDLE_DRONE,    "no_idle_drone",    "x",      "y",       NULL) \
+    X(FR_MISSION_EXPIRED,  "mission_expired",  "drone",  "x",       "y") \
+    X(FR_REQUEUE,          "requeue",          "drone",  "x",       "y") \
+    X(FR_WATCHDOG,         "watchdog",         "idle_s", NULL,      NULL)
+
+#define FLIGHT_EVENT_ID(id, name, a, b, c) id,
+typedef enum { FLIGHT_EVENTS(FLIGHT_EVENT_ID) FLIGHT_EVENT_COUNT } FlightEvent;
+#undef FLIGHT_EVENT_ID
+
+void flightrec_record(FlightEvent event, int a, int b, int c);
+// Dump into path (appended, one block per dump) on SIGSEGV/SIGABRT/SIGUSR2.
+// The path is copied. Returns 0, or -1 if the handlers cannot be installed.
+int flightrec_install(const char *path);
+// Append the ring to the file; safe to call from a signal handler
+void flightrec_dump(const char *reason);
+
+#endif // FLIGHTREC_H
@@ -0,0 +1,35 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+// Log-linear buckets: 2^HISTOGRAM_SUB_BITS buckets per power of two, so
+// any recorded value is reported within ~12% of what was recorded.
+#define HISTOGRAM_SUB_BITS 3
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+// Fixed-size latency histogram, no allocation. Not thread safe; callers
+// protect it with the lock of the object it is embedded in.
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint32_t buckets[HISTOGRAM_BUCKETS];
+} Histogram;
+
+void histogram_init(Histogram *h);
+// Index into buckets[] for value
+unsigned int histogram_bucket(uint64_t value);
+void histogram_record(Histogram *h, uint64_t value);
+void histogram_merge(Histogram *dst, const Histogram *src);
+// Single-writer variants: one thread (or whoever holds the owning lock)
+// records, other threads may merge concurrently without locking
+void histogram_record_relaxed(Histogram *h, uint64_t value);
+void histogram_merge_relaxed(Histogram *dst, const Histogram *src);
+// Samples in buckets that lie entirely at or below value (cumulative count
+// for a coarser bucket boundary, e.g. a Prometheus "le")
+uint64_t histogram_count_at_most(const Histogram *h, uint64_t value);
+// Upper edge of the bucket holding the q-th quantile (0 < q <= 1), capped at max
+uint64_t histogram_percentile(const Histogram *h, double q);
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,28 @@
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+// Load generator: many simulated drones in one process, driven by a single
+// epoll loop instead of a process and two threads per drone. Each drone
+// speaks the normal protocol (HANDSHAKE, STATUS_UPDATE, MISSION_COMPLETE,
+// HEARTBEAT_RESPONSE) and flies its missions cell by cell.
+//
+//   drone_client --load [-n drones] [-p port] [-s cells/s] [-u update_ms]
+//                       [-r connects/s] [-t seconds] [-i first_id] [-x time_scale]
+//
+// -s and -u are in simulated time: with -x 10 drones fly ten cells and
+// report ten times per wall second, stamped one simulated second apart.
+//
+// Prints achieved message rates every second and, at the end, the latency
+// from a drone reporting idle to its next ASSIGN_MISSION.
+
+#define LOADGEN_DEFAULT_DRONES 100
+#define LOADGEN_DEFAULT_SPEED 1          // cells per second
+#define LOADGEN_DEFAULT_UPDATE_MS 1000   // STATUS_UPDATE period per drone
+#define LOADGEN_DEFAULT_RAMP 50          // new connections per second, 0 = all at once
+#define LOADGEN_DEFAULT_DURATION 60      // seconds
+#define LOADGEN_DEFAULT_FIRST_ID 1000    // drone ids D1000, D1001, ...
+
+// argv[0] is "--load"; returns the process exit status
+int loadgen_main(int argc, char *argv[]);
+
+#endif // LOADGEN_H
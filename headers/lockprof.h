@@ -0,0 +1,47 @@
+#ifndef LOCKPROF_H
+#define LOCKPROF_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "histogram.h"
+
+// Lock contention profiler. Build with LOCK_PROFILING=1 (make) to record,
+// for every mutex given a name with lockprof_name(), how long threads wait
+// to acquire it and how long they hold it. Without it the wrappers are plain
+// pthread calls and nothing of the profiler is compiled in.
+
+#ifdef LOCK_PROFILING
+
+#define LOCKPROF_MAX_LOCKS 32
+
+typedef struct {
+    const char *name;
+    uint64_t acquisitions;
+    uint64_t contended;     // acquisitions that had to wait
+    Histogram wait;         // ns from request to acquisition
+    Histogram hold;         // ns from acquisition to release
+} LockStats;
+
+void lockprof_name(pthread_mutex_t *mutex, const char *name);
+int lockprof_lock(pthread_mutex_t *mutex);
+int lockprof_unlock(pthread_mutex_t *mutex);
+int lockprof_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex);
+// Copy the stats of up to max locks into out; returns how many
+int lockprof_snapshot(LockStats *out, int max);
+void lockprof_report(FILE *out);
+
+#define mutex_lock(m) lockprof_lock(m)
+#define mutex_unlock(m) lockprof_unlock(m)
+#define mutex_cond_wait(c, m) lockprof_cond_wait(c, m)
+
+#else
+
+#define lockprof_name(m, name) ((void)(m), (void)(name))
+#define mutex_lock(m) pthread_mutex_lock(m)
+#define mutex_unlock(m) pthread_mutex_unlock(m)
+#define mutex_cond_wait(c, m) pthread_cond_wait(c, m)
+
+#endif // LOCK_PROFILING
+
+#endif // LOCKPROF_H
@@ -0,0 +1,45 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+// Asynchronous leveled logger. A log call stores the format pointer and the
+// raw arguments (strings copied) into a ring owned by the calling thread;
+// the logger thread does the formatting and the writes. A call below the
+// module's level costs one compare. Formats must be string literals and may
+// use any printf conversion except '*' widths and %n; string arguments are
+// truncated to what fits in one record.
+
+typedef enum {
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+} LogLevel;
+
+typedef enum {
+    LOG_MOD_SERVER,     // connections and protocol handling
+    LOG_MOD_AI,         // mission assignment
+    LOG_MOD_DRONE,      // drone client
+    LOG_MODULE_COUNT
+} LogModule;
+
+// Records per thread; when a ring is full new records are dropped (counted)
+#define LOG_RING_SIZE 256
+
+extern LogLevel log_levels[LOG_MODULE_COUNT];
+
+// Read levels from $LOG_LEVEL ("info", "debug", "warn,ai=debug", ...) and
+// start the logger thread. Pending records are flushed at exit().
+void log_init(void);
+void log_write(LogModule module, LogLevel level, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define log_at(module, level, ...) \
+    do { if ((level) <= log_levels[module]) log_write((module), (level), __VA_ARGS__); } while (0)
+#define log_error(module, ...) log_at(module, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define log_warn(module, ...) log_at(module, LOG_LEVEL_WARN, __VA_ARGS__)
+#define log_info(module, ...) log_at(module, LOG_LEVEL_INFO, __VA_ARGS__)
+#define log_debug(module, ...) log_at(module, LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif // LOG_H
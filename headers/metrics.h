@@ -0,0 +1,75 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include "histogram.h"
+
+// Every metric the server exports. X(id, name, labels, help); metrics that
+// share a name are one family split by labels. Durations are recorded in
+// nanoseconds.
+#define METRIC_COUNTERS(X) \
+    X(CTR_RX_HANDSHAKE, "drone_messages_received_total", "type=\"HANDSHAKE\"", "Frames received from drones by message type") \
+    X(CTR_RX_STATUS_UPDATE, "drone_messages_received_total", "type=\"STATUS_UPDATE\"", "Frames received from drones by message type") \
+    X(CTR_RX_MISSION_COMPLETE, "drone_messages_received_total", "type=\"MISSION_COMPLETE\"", "Frames received from drones by message type") \
+    X(CTR_RX_HEARTBEAT_RESPONSE, "drone_messages_received_total", "type=\"HEARTBEAT_RESPONSE\"", "Frames received from drones by message type") \
+    X(CTR_RX_UNKNOWN, "drone_messages_received_total", "type=\"UNKNOWN\"", "Frames received from drones by message type") \
+    X(CTR_RX_MALFORMED, "drone_malformed_frames_total", "", "Frames dropped because they were not valid JSON") \
+    X(CTR_RX_BYTES, "drone_bytes_received_total", "", "Bytes of frames received from drones") \
+    X(CTR_STATUS_CELLS, "drone_reported_cells_total", "", "Cells moved between consecutive STATUS_UPDATE positions") \
+    X(CTR_TX_ASSIGN_MISSION, "drone_messages_sent_total", "type=\"ASSIGN_MISSION\"", "Frames sent to drones by message type") \
+    X(CTR_TX_HEARTBEAT, "drone_messages_sent_total", "type=\"HEARTBEAT\"", "Frames sent to drones by message type") \
+    X(CTR_MISSIONS_COMPLETED, "missions_completed_total", "", "MISSION_COMPLETE reports accepted") \
+    X(CTR_MISSIONS_EXPIRED, "missions_expired_total", "", "Missions requeued after their expiry passed") \
+    X(CTR_DRONES_DROPPED, "drones_dropped_total", "", "Drones removed after missed heartbeats or failed reconnect") \
+    X(CTR_SESSIONS_RESUMED, "drone_sessions_resumed_total", "", "Reconnects that got their drone record and mission back") \
+    X(CTR_HANDSHAKES_REJECTED, "drone_handshakes_rejected_total", "", "Handshakes refused because max_drones drones were registered") \
+    X(CTR_FEED_BYTES, "feed_bytes_sent_total", "", "Bytes of state feed sent to subscribers")
+
+#define METRIC_GAUGES(X) \
+    X(GAUGE_DRONES_CONNECTED, "drones_connected", "", "Drones currently registered") \
+    X(GAUGE_DRONES_ON_MISSION, "drones_on_mission", "", "Registered drones with a mission in flight") \
+    X(GAUGE_SURVIVORS_WAITING, "survivors_waiting", "queue=\"new\"", "Survivors waiting for a drone by queue") \
+    X(GAUGE_SURVIVORS_PRIORITY, "survivors_waiting", "queue=\"priority\"", "Survivors waiting for a drone by queue") \
+    X(GAUGE_FEED_SUBSCRIBERS, "feed_subscribers", "", "Viewers attached to the state feed")
+
+#define METRIC_HISTOGRAMS(X) \
+    X(HIST_PARSE_TIME, "message_parse_seconds", "", "Time to parse one inbound frame") \
+    X(HIST_ASSIGNMENT_LATENCY, "mission_assignment_seconds", "", "Time from taking a survivor off the queue to sending ASSIGN_MISSION") \
+    X(HIST_SURVIVOR_WAIT, "survivor_wait_seconds", "", "Time from survivor discovery to mission assignment") \
+    X(HIST_HEARTBEAT_RTT, "heartbeat_rtt_seconds", "", "HEARTBEAT to HEARTBEAT_RESPONSE round trip") \
+    X(HIST_FRAME_TIME, "render_frame_seconds", "", "Time to draw one map frame, excluding present")
+
+#define METRIC_ENUM(id, name, labels, help) id,
+typedef enum { METRIC_COUNTERS(METRIC_ENUM) COUNTER_COUNT } CounterId;
+typedef enum { METRIC_GAUGES(METRIC_ENUM) GAUGE_COUNT } GaugeId;
+typedef enum { METRIC_HISTOGRAMS(METRIC_ENUM) HISTOGRAM_COUNT } HistogramId;
+#undef METRIC_ENUM
+
+typedef struct {
+    const char *name;
+    const char *labels;   // "" when the metric has none
+    const char *help;
+} MetricDesc;
+
+extern const MetricDesc counter_desc[COUNTER_COUNT];
+extern const MetricDesc gauge_desc[GAUGE_COUNT];
+extern const MetricDesc histogram_desc[HISTOGRAM_COUNT];
+
+// Write side: no locks and no shared cache lines. Counters and histograms
+// go to a shard owned by the calling thread; gauges are single atomics.
+void metrics_inc(CounterId id);
+void metrics_add(CounterId id, uint64_t value);
+void metrics_observe(HistogramId id, uint64_t value);
+void metrics_gauge_set(GaugeId id, int64_t value);
+void metrics_gauge_add(GaugeId id, int64_t delta);
+
+// Read side: sums every live shard plus those of exited threads
+typedef struct {
+    uint64_t counters[COUNTER_COUNT];
+    int64_t gauges[GAUGE_COUNT];
+    Histogram histograms[HISTOGRAM_COUNT];
+} MetricsSnapshot;
+
+void metrics_snapshot(MetricsSnapshot *snapshot);
+
+#endif // METRICS_H
@@ -0,0 +1,33 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include <stdio.h>
+
+// Software renderer for headless visual snapshots. Draws the same scene as
+// the SDL view (survivors, drones, targets, mission lines, grid) for the
+// whole map into an RGB buffer, without SDL or a display, and encodes it as
+// PPM or PNG.
+
+#define OFFSCREEN_MAX_PX 1600   // longest image side; big maps are scaled down
+#define OFFSCREEN_DIR "frames"  // where periodic frames are written
+
+typedef enum {
+    FRAME_PPM,
+    FRAME_PNG
+} FrameFormat;
+
+// Capture the world now and write one encoded frame; 0 on success
+int offscreen_write_frame(FILE *out, FrameFormat format);
+
+// Frames for the admin endpoint, rendered on a background thread. Request a
+// frame (the thread starts on first use; -1 if it cannot), wait for
+// offscreen_notify_fd() to become readable and drain it, then collect:
+// 1 with a malloc'd copy in *data, -1 if rendering failed, 0 if not done yet.
+int offscreen_request(FrameFormat format, unsigned long *seq);
+int offscreen_notify_fd(void);
+int offscreen_collect(FrameFormat format, unsigned long seq, char **data, size_t *len);
+// Write OFFSCREEN_DIR/frame-NNNNNN.png every interval_s seconds from a
+// background thread, for timelapses
+void offscreen_start(int interval_s);
+
+#endif // OFFSCREEN_H
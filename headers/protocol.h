@@ -0,0 +1,88 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "../cJSON/cJSON.h"
+
+// Messages on the wire are newline-delimited JSON objects
+#define FRAME_BUFFER_SIZE 4096
+
+// Per-connection receive buffer that splits the byte stream into frames.
+// A single recv() may carry several frames, or only part of one.
+typedef struct {
+    int sockfd;
+    size_t start;   // first byte not yet handed out
+    size_t end;     // one past the last received byte
+    char buffer[FRAME_BUFFER_SIZE];
+} FrameReader;
+
+// Protocol message types, see communication-protocol.md
+typedef enum {
+    MSG_UNKNOWN = 0,
+    MSG_HANDSHAKE,
+    MSG_HANDSHAKE_ACK,
+    MSG_STATUS_UPDATE,
+    MSG_MISSION_COMPLETE,
+    MSG_HEARTBEAT,
+    MSG_HEARTBEAT_RESPONSE,
+    MSG_ASSIGN_MISSION,
+    MSG_ERROR
+} MessageType;
+
+MessageType message_type_from_name(const char *name, size_t length);
+// Type of a raw frame without parsing it; relies on "type" being the first
+// key, as every sender in this system writes it. MSG_UNKNOWN if it is not.
+MessageType sniff_message_type(const char *frame, size_t length);
+// Unsigned integer value of "key" in a raw frame without parsing it. Takes
+// the first "key": in the frame, so only use it on message types where the
+// key cannot also appear inside a string. 1 if found, 0 otherwise.
+int sniff_uint_field(const char *frame, size_t length, const char *key, uint64_t *value);
+// Type of an already parsed message (for frames the sniffer could not place)
+MessageType message_type_from_json(cJSON *msg);
+
+// Growable output buffer reused across messages; owned by one thread
+typedef struct {
+    char *data;
+    size_t capacity;
+} PrintBuffer;
+
+// Serialize json plus the newline delimiter into buf; returns frame length (0 on failure)
+size_t print_json_frame(cJSON *json, PrintBuffer *buf);
+// Calling thread's PrintBuffer, created on first use and freed at thread exit
+PrintBuffer *thread_print_buffer(void);
+// Send all len bytes; returns 0 on success, -1 if the peer is gone
+int send_all(int sockfd, const char *data, size_t len);
+// Serialize into the thread's buffer and send the frame with a single send()
+int send_json(int sockfd, cJSON *json);
+
+// Pre-rendered message whose few varying fields are patched in per send.
+// Build the JSON with cJSON_AddRawToObject(obj, name, FRAME_SLOT) for each
+// varying field; values are substituted in the order the slots appear.
+#define FRAME_SLOT "\x01"
+#define FRAME_TEMPLATE_MAX_SLOTS 8
+
+typedef struct {
+    char *text;         // frame with the slot markers removed
+    size_t length;
+    int slot_count;
+    size_t slots[FRAME_TEMPLATE_MAX_SLOTS];  // insertion offsets into text
+} FrameTemplate;
+
+FrameTemplate *frame_template_create(cJSON *json);
+void frame_template_destroy(FrameTemplate *tmpl);
+// values are JSON literals (numbers, or quoted strings needing no escaping)
+size_t frame_template_render(const FrameTemplate *tmpl, PrintBuffer *out, const char *const values[]);
+
+void frame_reader_init(FrameReader *reader, int sockfd);
+// Next complete frame (newline replaced by '\0') or NULL if none is buffered
+char *frame_next(FrameReader *reader, size_t *length);
+// Receive more bytes from the socket; returns the recv() result
+ssize_t frame_fill(FrameReader *reader);
+// Next raw frame, receiving as needed. NULL on timeout/disconnect (errno from recv)
+char *recv_frame(FrameReader *reader, size_t *length);
+// Parse the next frame, receiving as needed. NULL on timeout/disconnect (errno from recv)
+cJSON *recv_json(FrameReader *reader);
+
+#endif // PROTOCOL_H
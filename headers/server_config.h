@@ -9,10 +9,18 @@ typedef struct {
     int map_height;        // Map height
     int survivor_spawn_rate;  // Rate at which survivors spawn (in seconds)
     int drone_speed;       // Speed of the drones
+    int heartbeat_interval;   // Seconds of silence before a drone is probed
+    int admin_port;        // Local HTTP metrics port, 0 to disable
+    int feed_port;         // Local binary state feed port, 0 to disable
+    int frame_interval;    // Seconds between PNG frames in frames/, 0 to disable
 } ServerConfig;
 
 // Function declarations
 void print_server_banner(void);
+// Defaults, overridden from the environment:
+//   HEARTBEAT_INTERVAL=<seconds>  probe interval advertised to drones (10)
+//   MAX_DRONES=<n>                drones registered at once (64)
+//   FRAME_INTERVAL=<seconds>      write a timelapse PNG to frames/ (off)
 ServerConfig get_server_config(void);
 void apply_server_config(ServerConfig config);
 
@@ -0,0 +1,21 @@
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+#include <time.h>
+
+// Simulated time for the drone client. At scale N, motion and every
+// timestamp the client sends advance N times faster than the wall clock,
+// so a 500-cell mission takes 500/N seconds and still reports one second
+// per cell. In virtual mode nothing sleeps: waiting only moves the clock.
+// Liveness checks against the server stay on wall time.
+
+// Call once before any other simclock function; scale 1 is real time
+void simclock_init(double scale, int virtual_time);
+// Simulated wall-clock seconds, for message timestamps
+time_t simclock_now(void);
+// Wait ms of simulated time
+void simclock_sleep_ms(unsigned int ms);
+// Wall nanoseconds for ns of simulated time (virtual mode: 0)
+unsigned long long simclock_wall_ns(unsigned long long ns);
+
+#endif // SIMCLOCK_H
@@ -0,0 +1,53 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include "coord.h"
+
+// Copy of the world taken at a fixed rate for the renderer. The simulation
+// side fills one of three buffers and publishes it; the reader always gets
+// the newest complete copy and never touches the live lists or their locks.
+
+#define SNAPSHOT_INTERVAL_MS 100
+
+typedef enum {
+    SNAP_SURVIVOR_WAITING,
+    SNAP_SURVIVOR_PRIORITY,   // requeued after its drone was lost
+    SNAP_SURVIVOR_HELPED
+} SnapshotSurvivorKind;
+
+typedef struct {
+    int id;
+    int status;               // DroneStatus
+    Coord coord;
+    Coord target;
+} SnapshotDrone;
+
+typedef struct {
+    uint32_t id;              // Survivor id
+    Coord coord;
+    int kind;                 // SnapshotSurvivorKind
+} SnapshotSurvivor;
+
+typedef struct {
+    uint64_t seq;             // 1 for the first publish, 0 before any
+    uint64_t taken_ns;        // monotonic_ns() at capture
+    int map_width, map_height;
+    int drone_count, drone_capacity;
+    SnapshotDrone *drones;
+    int survivor_count, survivor_capacity;
+    SnapshotSurvivor *survivors;
+} WorldSnapshot;
+
+// Publish a snapshot every SNAPSHOT_INTERVAL_MS from the timer service
+void snapshot_start(void);
+// Capture and publish one snapshot now
+void snapshot_publish(void);
+// Copy the world into a snapshot owned by the caller (arrays grow as
+// needed and are reused; start from a zeroed WorldSnapshot). seq is untouched.
+void snapshot_capture(WorldSnapshot *snap);
+// Newest published snapshot. Single reader: the result stays valid and
+// unchanged until that reader's next call.
+const WorldSnapshot *snapshot_acquire(void);
+
+#endif // SNAPSHOT_H
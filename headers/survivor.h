@@ -4,13 +4,16 @@
 #include "coord.h"
 #include <time.h>
 #include "list.h"
+#include <stdint.h>
 typedef struct survivor {
+    uint32_t id;         // unique for the server's lifetime
     int status;
     Coord coord;
     struct tm discovery_time;
     struct tm helped_time;
     char info[25];
     int emergency_level; // 1=critical survivor, 0=normal
+    uint64_t queued_ns;  // monotonic time it (re)entered a waiting queue
 } Survivor;
 
 // Global survivor lists (extern)
@@ -0,0 +1,33 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Resolution of the timer service
+#define TIMER_TICK_MS 100
+
+typedef void (*TimerCallback)(void *arg);
+
+// Intrusive timer, embed it in the object it belongs to.
+// Callbacks run on the timer thread, one at a time, without any timer lock held.
+typedef struct timer {
+    struct timer *next;
+    struct timer **pprev;   // NULL when not scheduled
+    uint64_t expires;       // in ticks
+    TimerCallback callback;
+    void *arg;
+} Timer;
+
+// Start the single thread that advances the wheel and fires callbacks
+void timer_service_start(void);
+void timer_init(Timer *timer, TimerCallback callback, void *arg);
+// Arm (or re-arm) timer to fire after delay_ms; O(1)
+void timer_schedule(Timer *timer, unsigned int delay_ms);
+// Disarm timer if pending; O(1). A callback already running is not waited for.
+void timer_cancel(Timer *timer);
+bool timer_pending(Timer *timer);
+// CLOCK_MONOTONIC in nanoseconds, for measuring intervals
+uint64_t monotonic_ns(void);
+
+#endif // TIMER_H
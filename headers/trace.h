@@ -0,0 +1,20 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Mission lifecycle tracing. Each phase of a mission (queued, dispatch,
+// travel) is recorded as one span into a ring owned by the calling thread;
+// trace_write_chrome() dumps every ring as a Chrome/Perfetto trace with one
+// track per mission.
+
+// Per-thread ring size; older spans are overwritten
+#define TRACE_RING_SIZE 1024
+
+// name must be a string literal (only the pointer is stored)
+void trace_span(const char *name, uint32_t mission, int drone_id, uint64_t start_ns, uint64_t end_ns);
+// JSON object format understood by chrome://tracing and ui.perfetto.dev
+void trace_write_chrome(FILE *out);
+
+#endif // TRACE_H
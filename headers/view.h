@@ -2,6 +2,7 @@
 #define VIEW_H
 
 #include <SDL2/SDL.h>
+#include "snapshot.h"
 
 // SDL globals
 extern SDL_Window* window;
@@ -14,8 +15,8 @@ extern int init_sdl_window(void);
 extern int init_sdl_main_thread(void);
 extern int wait_for_sdl_init(void);
 extern void draw_cell(int x, int y, SDL_Color color);
-extern void draw_drones(void);
-extern void draw_survivors(void);
+extern void draw_drones(const WorldSnapshot *snap);
+extern void draw_survivors(const WorldSnapshot *snap);
 extern void draw_grid(void);
 extern int draw_map(void);
 extern int check_events(void);
@@ -0,0 +1,81 @@
+// Log-linear latency histogram (HDR-style, fixed precision)
+#include "headers/histogram.h"
+#include <string.h>
+
+#define SUB_COUNT (1u << HISTOGRAM_SUB_BITS)
+
+unsigned int histogram_bucket(uint64_t value) {
+    if (value < SUB_COUNT) return (unsigned int)value;
+    unsigned int exponent = 63 - (unsigned int)__builtin_clzll(value);
+    unsigned int sub = (unsigned int)(value >> (exponent - HISTOGRAM_SUB_BITS)) & (SUB_COUNT - 1);
+    return ((exponent - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS) + sub;
+}
+
+// Largest value that lands in bucket index
+static uint64_t bucket_upper(unsigned int index) {
+    if (index < SUB_COUNT) return index;
+    unsigned int shift = (index >> HISTOGRAM_SUB_BITS) - 1;
+    uint64_t lower = (uint64_t)(SUB_COUNT + (index & (SUB_COUNT - 1))) << shift;
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+void histogram_init(Histogram *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void histogram_record(Histogram *h, uint64_t value) {
+    h->buckets[histogram_bucket(value)]++;
+    h->count++;
+    h->sum += value;
+    if (value > h->max) h->max = value;
+}
+
+void histogram_merge(Histogram *dst, const Histogram *src) {
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++) dst->buckets[i] += src->buckets[i];
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+// Relaxed load and store rather than an atomic add: there is one writer,
+// so this costs no locked instruction; readers may see a value one update old
+#define RELAXED_ADD(field, value) \
+    __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+#define RELAXED_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+void histogram_record_relaxed(Histogram *h, uint64_t value) {
+    RELAXED_ADD(h->buckets[histogram_bucket(value)], 1);
+    RELAXED_ADD(h->count, 1);
+    RELAXED_ADD(h->sum, value);
+    if (value > RELAXED_LOAD(h->max)) __atomic_store_n(&h->max, value, __ATOMIC_RELAXED);
+}
+
+void histogram_merge_relaxed(Histogram *dst, const Histogram *src) {
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++) dst->buckets[i] += RELAXED_LOAD(src->buckets[i]);
+    dst->count += RELAXED_LOAD(src->count);
+    dst->sum += RELAXED_LOAD(src->sum);
+    uint64_t max = RELAXED_LOAD(src->max);
+    if (max > dst->max) dst->max = max;
+}
+
+uint64_t histogram_count_at_most(const Histogram *h, uint64_t value) {
+    uint64_t count = 0;
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS && bucket_upper(i) <= value; i++) count += h->buckets[i];
+    return count;
+}
+
+uint64_t histogram_percentile(const Histogram *h, double q) {
+    if (!h->count) return 0;
+    uint64_t rank = (uint64_t)(q * (double)h->count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > h->count) rank = h->count;
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper(i);
+            return upper < h->max ? upper : h->max;
+        }
+    }
+    return h->max;
+}
@@ -12,6 +12,7 @@
  *
  */
 #include "headers/list.h"
+#include "headers/lockprof.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -123,13 +124,13 @@ static Node *find_memcell_fornode(List *list) {
 Node *add(List *list, void *data) {
     Node *node = NULL;
 
-    pthread_mutex_lock(&list->lock);
+    mutex_lock(&list->lock);
 
     // Wait while the list is full
     while (list->number_of_elements >= list->capacity) {
-        if (pthread_cond_wait(&list->not_full_cv, &list->lock) != 0) {
+        if (mutex_cond_wait(&list->not_full_cv, &list->lock) != 0) {
             perror("pthread_cond_wait failed on not_full_cv");
-            pthread_mutex_unlock(&list->lock);
+            mutex_unlock(&list->lock);
             return NULL;
         }
     }
@@ -168,7 +169,7 @@ Node *add(List *list, void *data) {
         perror("list is full or failed to find memory cell (unexpected in add after capacity check)");
     }
 
-    pthread_mutex_unlock(&list->lock);
+    mutex_unlock(&list->lock);
     return node;
 }
 /**
@@ -181,7 +182,7 @@ Node *add(List *list, void *data) {
 int removedata(List *list, void *data) {
     int result = 1;  // Default to "not found"
     
-    pthread_mutex_lock(&list->lock);
+    mutex_lock(&list->lock);
     
     Node *temp = list->head;
     while (temp != NULL &&
@@ -219,7 +220,7 @@ int removedata(List *list, void *data) {
         result = 0;  // Success
     }
     
-    pthread_mutex_unlock(&list->lock);
+    mutex_unlock(&list->lock);
     return result;
 }
 /**
@@ -235,13 +236,13 @@ void *pop(List *list, void *dest) {
         return NULL;
     }
 
-    pthread_mutex_lock(&list->lock);
+    mutex_lock(&list->lock);
 
     // Wait while the list is empty
     while (list->number_of_elements == 0) {
-        if (pthread_cond_wait(&list->not_empty_cv, &list->lock) != 0) {
+        if (mutex_cond_wait(&list->not_empty_cv, &list->lock) != 0) {
             perror("pthread_cond_wait failed on not_empty_cv");
-            pthread_mutex_unlock(&list->lock);
+            mutex_unlock(&list->lock);
             return NULL;
         }
     }
@@ -267,7 +268,7 @@ void *pop(List *list, void *dest) {
         perror("List became empty unexpectedly after wait in pop");
     }
 
-    pthread_mutex_unlock(&list->lock);
+    mutex_unlock(&list->lock);
     return result_data;
 }
 /**
@@ -278,11 +279,11 @@ void *pop(List *list, void *dest) {
 void *peek(List *list) {
     void *result = NULL;
     
-    pthread_mutex_lock(&list->lock);
+    mutex_lock(&list->lock);
     if (list->head != NULL) {
         result = list->head->data;
     }
-    pthread_mutex_unlock(&list->lock);
+    mutex_unlock(&list->lock);
     
     return result;
 }
@@ -359,7 +360,7 @@ void destroy(List *list) {
  */
 void printlist(List *list, void (*print)(void *)) {
     if (!list) return;
-    pthread_mutex_lock(&list->lock);
+    mutex_lock(&list->lock);
     Node *temp = list->head;
     printf("List (Head to Tail):\n");
     while (temp != NULL) {
@@ -367,7 +368,7 @@ void printlist(List *list, void (*print)(void *)) {
         temp = temp->next;
     }
     printf("End of List\n");
-    pthread_mutex_unlock(&list->lock);
+    mutex_unlock(&list->lock);
 }
 /**
  * @brief print list starting from tail
@@ -377,7 +378,7 @@ void printlist(List *list, void (*print)(void *)) {
  */
 void printlistfromtail(List *list, void (*print)(void *)) {
     if (!list) return;
-    pthread_mutex_lock(&list->lock);
+    mutex_lock(&list->lock);
     Node *temp = list->tail;
     printf("List (Tail to Head):\n");
     while (temp != NULL) {
@@ -385,5 +386,5 @@ void printlistfromtail(List *list, void (*print)(void *)) {
         temp = temp->prev;
     }
     printf("End of List (from Tail)\n");
-    pthread_mutex_unlock(&list->lock);
+    mutex_unlock(&list->lock);
 }
\ No newline at end of file
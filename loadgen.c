@@ -0,0 +1,413 @@
+// Load generator mode of drone_client: N simulated drones over one epoll
+// loop. Drones are plain structs; all due work (connect ramp, movement,
+// status updates) is found by a scan every LOADGEN_TICK_MS.
+#include "headers/loadgen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <getopt.h>
+#include <signal.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include "cJSON/cJSON.h"
+#include "headers/protocol.h"
+#include "headers/histogram.h"
+#include "headers/simclock.h"
+
+#define LOADGEN_TICK_MS 10
+#define LOADGEN_SERVER_IP "127.0.0.1"
+#define LOADGEN_OUT_MAX 65536    // unsent bytes before a drone is cut off
+
+typedef enum {
+    SIM_WAITING,        // not connected yet (ramp)
+    SIM_CONNECTING,
+    SIM_HANDSHAKE,      // HANDSHAKE sent, waiting for the ACK
+    SIM_IDLE,
+    SIM_MISSION,
+    SIM_CLOSED
+} SimState;
+
+typedef struct {
+    int fd;
+    int id;
+    SimState state;
+    int x, y, target_x, target_y;
+    char mission_id[16];
+    uint64_t next_move_ns;
+    uint64_t next_update_ns;
+    uint64_t idle_since_ns;     // when it last reported idle, for assignment latency
+    FrameReader reader;
+    char *out;                  // bytes send() did not take yet
+    size_t out_len;
+} SimDrone;
+
+typedef enum {
+    TX_HANDSHAKE, TX_STATUS_UPDATE, TX_MISSION_COMPLETE, TX_HEARTBEAT_RESPONSE, TX_KINDS
+} TxKind;
+
+typedef struct {
+    uint64_t tx[TX_KINDS];
+    uint64_t rx_ack, rx_heartbeat, rx_assign, rx_other;
+    uint64_t connect_failures, disconnects, missions_completed, rejected;
+} LoadStats;
+
+static const char *tx_names[TX_KINDS] = { "HANDSHAKE", "STATUS_UPDATE", "MISSION_COMPLETE", "HEARTBEAT_RESPONSE" };
+
+static volatile sig_atomic_t stop_requested;
+static int epfd;
+static struct sockaddr_in server_addr;
+static LoadStats stats;
+static Histogram assign_latency;
+static int connected;
+
+static void on_signal(int sig) {
+    stop_requested = 1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void close_drone(SimDrone *d) {
+    if (d->fd >= 0) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, d->fd, NULL);
+        close(d->fd);
+    }
+    if (d->state >= SIM_IDLE && d->state <= SIM_MISSION) connected--;
+    d->fd = -1;
+    d->state = SIM_CLOSED;
+    free(d->out);
+    d->out = NULL;
+    d->out_len = 0;
+}
+
+static void watch(SimDrone *d, int want_write) {
+    struct epoll_event ev = { .events = EPOLLIN | (want_write ? EPOLLOUT : 0), .data.ptr = d };
+    epoll_ctl(epfd, EPOLL_CTL_MOD, d->fd, &ev);
+}
+
+static void flush_out(SimDrone *d) {
+    size_t sent = 0;
+    while (sent < d->out_len) {
+        ssize_t n = send(d->fd, d->out + sent, d->out_len - sent, MSG_NOSIGNAL);
+        if (n > 0) { sent += (size_t)n; continue; }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        stats.disconnects++;
+        close_drone(d);
+        return;
+    }
+    memmove(d->out, d->out + sent, d->out_len - sent);
+    d->out_len -= sent;
+    if (d->out_len == 0) watch(d, 0);
+}
+
+// Queue one frame and try to send it right away
+static void send_frame(SimDrone *d, TxKind kind, const char *frame, int len) {
+    if (d->fd < 0 || len <= 0) return;
+    if (d->out_len + (size_t)len > LOADGEN_OUT_MAX) {
+        stats.disconnects++;
+        close_drone(d);
+        return;
+    }
+    int was_empty = d->out_len == 0;
+    char *out = realloc(d->out, d->out_len + (size_t)len);
+    if (!out) return;
+    d->out = out;
+    memcpy(d->out + d->out_len, frame, (size_t)len);
+    d->out_len += (size_t)len;
+    stats.tx[kind]++;
+    if (!was_empty) return;     // EPOLLOUT is already armed
+    flush_out(d);
+    if (d->fd >= 0 && d->out_len) watch(d, 1);
+}
+
+static void send_status(SimDrone *d) {
+    char frame[256];
+    int len = snprintf(frame, sizeof(frame),
+        "{\"type\":\"STATUS_UPDATE\",\"drone_id\":\"D%d\",\"timestamp\":%d,\"location\":{\"x\":%d,\"y\":%d},"
+        "\"status\":\"%s\",\"battery\":100,\"speed\":1}\n",
+        d->id, (int)simclock_now(), d->x, d->y, d->state == SIM_MISSION ? "busy" : "idle");
+    send_frame(d, TX_STATUS_UPDATE, frame, len);
+}
+
+static void start_connect(SimDrone *d) {
+    d->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (d->fd < 0) {
+        stats.connect_failures++;
+        d->state = SIM_CLOSED;
+        return;
+    }
+    frame_reader_init(&d->reader, d->fd);
+    if (connect(d->fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0 && errno != EINPROGRESS) {
+        stats.connect_failures++;
+        close(d->fd);
+        d->fd = -1;
+        d->state = SIM_CLOSED;
+        return;
+    }
+    d->state = SIM_CONNECTING;
+    struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = d };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, d->fd, &ev);
+}
+
+static void connect_done(SimDrone *d) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(d->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err) {
+        stats.connect_failures++;
+        close_drone(d);
+        return;
+    }
+    d->state = SIM_HANDSHAKE;
+    watch(d, 0);
+    char frame[256];
+    int n = snprintf(frame, sizeof(frame),
+        "{\"type\":\"HANDSHAKE\",\"drone_id\":\"D%d\",\"capabilities\":"
+        "{\"max_speed\":30,\"battery_capacity\":100,\"payload\":\"medical\"}}\n", d->id);
+    send_frame(d, TX_HANDSHAKE, frame, n);
+}
+
+static void handle_frame(SimDrone *d, const char *frame, size_t len, uint64_t now) {
+    MessageType type = sniff_message_type(frame, len);
+    if (type == MSG_HANDSHAKE_ACK) {
+        stats.rx_ack++;
+        if (d->state != SIM_HANDSHAKE) return;
+        d->state = SIM_IDLE;
+        connected++;
+        d->idle_since_ns = now;
+        d->next_update_ns = now;
+        send_status(d);
+        return;
+    }
+    if (type == MSG_HEARTBEAT) {
+        // echo sent_ns straight from the raw frame, no parse
+        stats.rx_heartbeat++;
+        char reply[192];
+        uint64_t sent_ns;
+        int n = sniff_uint_field(frame, len, "sent_ns", &sent_ns)
+            ? snprintf(reply, sizeof(reply), "{\"type\":\"HEARTBEAT_RESPONSE\",\"drone_id\":\"D%d\",\"timestamp\":%d,\"sent_ns\":%llu}\n",
+                       d->id, (int)simclock_now(), (unsigned long long)sent_ns)
+            : snprintf(reply, sizeof(reply), "{\"type\":\"HEARTBEAT_RESPONSE\",\"drone_id\":\"D%d\",\"timestamp\":%d}\n",
+                       d->id, (int)simclock_now());
+        send_frame(d, TX_HEARTBEAT_RESPONSE, reply, n);
+        return;
+    }
+    if (type == MSG_ERROR && d->state == SIM_HANDSHAKE) {
+        // Server full (max_drones): it closes the connection after this
+        stats.rejected++;
+        close_drone(d);
+        return;
+    }
+    if (type != MSG_ASSIGN_MISSION) {
+        stats.rx_other++;
+        return;
+    }
+    cJSON *msg = cJSON_ParseWithLength(frame, len);
+    if (!msg) return;
+    stats.rx_assign++;
+    cJSON *target = cJSON_GetObjectItem(msg, "target");
+    cJSON *tx = target ? cJSON_GetObjectItem(target, "x") : NULL;
+    cJSON *ty = target ? cJSON_GetObjectItem(target, "y") : NULL;
+    cJSON *mid = cJSON_GetObjectItem(msg, "mission_id");
+    if (cJSON_IsNumber(tx) && cJSON_IsNumber(ty) && d->state == SIM_IDLE) {
+        histogram_record(&assign_latency, now - d->idle_since_ns);
+        d->target_x = tx->valueint;
+        d->target_y = ty->valueint;
+        snprintf(d->mission_id, sizeof(d->mission_id), "%s", cJSON_IsString(mid) ? mid->valuestring : "0");
+        d->state = SIM_MISSION;
+    }
+    cJSON_Delete(msg);
+}
+
+static void read_frames(SimDrone *d, uint64_t now) {
+    for (;;) {
+        size_t len;
+        char *frame;
+        while (d->fd >= 0 && (frame = frame_next(&d->reader, &len))) handle_frame(d, frame, len, now);
+        if (d->fd < 0) return;
+        ssize_t n = frame_fill(&d->reader);
+        if (n > 0) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        stats.disconnects++;
+        close_drone(d);
+        return;
+    }
+}
+
+// One cell per step period, X first then Y like movement_thread
+static void step(SimDrone *d, uint64_t now, uint64_t step_ns) {
+    if (d->state != SIM_MISSION || now < d->next_move_ns) return;
+    d->next_move_ns = now + step_ns;
+    if (d->x != d->target_x) {
+        d->x += d->x < d->target_x ? 1 : -1;
+    } else if (d->y != d->target_y) {
+        d->y += d->y < d->target_y ? 1 : -1;
+    }
+    if (d->x != d->target_x || d->y != d->target_y) return;
+    char frame[256];
+    int n = snprintf(frame, sizeof(frame),
+        "{\"type\":\"MISSION_COMPLETE\",\"drone_id\":\"D%d\",\"mission_id\":\"%s\",\"timestamp\":%d,"
+        "\"success\":true,\"details\":\"Delivered aid to survivor.\"}\n", d->id, d->mission_id, (int)simclock_now());
+    send_frame(d, TX_MISSION_COMPLETE, frame, n);
+    stats.missions_completed++;
+    d->state = SIM_IDLE;
+    d->idle_since_ns = now;
+    send_status(d);
+}
+
+static void print_rates(const LoadStats *now, const LoadStats *before, double seconds) {
+    printf("[LOAD] connected %d | tx/s", connected);
+    for (int k = 0; k < TX_KINDS; k++)
+        printf(" %s %.0f", tx_names[k], (double)(now->tx[k] - before->tx[k]) / seconds);
+    printf(" | rx/s ASSIGN %.1f HEARTBEAT %.1f | missions done %llu\n",
+           (double)(now->rx_assign - before->rx_assign) / seconds,
+           (double)(now->rx_heartbeat - before->rx_heartbeat) / seconds,
+           (unsigned long long)now->missions_completed);
+    fflush(stdout);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s --load [-n drones] [-p port] [-s cells/s] [-u update_ms] [-r connects/s] [-t seconds] [-i first_id] [-x time_scale]\n", prog);
+    fprintf(stderr, "The server turns away drones past its max_drones (64); start it with MAX_DRONES=<n> for larger fleets\n");
+}
+
+int loadgen_main(int argc, char *argv[]) {
+    int count = LOADGEN_DEFAULT_DRONES, port = 2100, speed = LOADGEN_DEFAULT_SPEED;
+    int update_ms = LOADGEN_DEFAULT_UPDATE_MS, ramp = LOADGEN_DEFAULT_RAMP;
+    int duration = LOADGEN_DEFAULT_DURATION, first_id = LOADGEN_DEFAULT_FIRST_ID;
+    double time_scale = 1.0;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:p:s:u:r:t:i:x:")) != -1) {
+        switch (opt) {
+            case 'n': count = atoi(optarg); break;
+            case 'p': port = atoi(optarg); break;
+            case 's': speed = atoi(optarg); break;
+            case 'u': update_ms = atoi(optarg); break;
+            case 'r': ramp = atoi(optarg); break;
+            case 't': duration = atoi(optarg); break;
+            case 'i': first_id = atoi(optarg); break;
+            case 'x': time_scale = atof(optarg); break;
+            default: usage("drone_client"); return EXIT_FAILURE;
+        }
+    }
+    if (count <= 0 || speed <= 0 || update_ms <= 0 || ramp < 0 || duration <= 0 || time_scale <= 0) {
+        usage("drone_client");
+        return EXIT_FAILURE;
+    }
+
+    // One descriptor per drone plus a few spare
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < (rlim_t)count + 16) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+        if (lim.rlim_cur < (rlim_t)count + 16)
+            fprintf(stderr, "[LOAD] Open file limit %llu is below %d drones\n", (unsigned long long)lim.rlim_cur, count);
+    }
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    inet_pton(AF_INET, LOADGEN_SERVER_IP, &server_addr.sin_addr);
+
+    SimDrone *fleet = calloc((size_t)count, sizeof(SimDrone));
+    struct epoll_event *events = malloc(sizeof(struct epoll_event) * 256);
+    epfd = epoll_create1(0);
+    if (!fleet || !events || epfd < 0) {
+        perror("loadgen");
+        return EXIT_FAILURE;
+    }
+    histogram_init(&assign_latency);
+    simclock_init(time_scale, 0);
+    for (int i = 0; i < count; i++) {
+        fleet[i].fd = -1;
+        fleet[i].id = first_id + i;
+        fleet[i].state = SIM_WAITING;
+    }
+    printf("[LOAD] %d drones D%d..D%d -> port %d, %d cells/s, status every %d ms, ramp %d/s, %d s, time x%g\n",
+           count, first_id, first_id + count - 1, port, speed, update_ms, ramp, duration, time_scale);
+
+    uint64_t start = now_ns();
+    uint64_t end = start + (uint64_t)duration * 1000000000ull;
+    // Speed and update period are in simulated time
+    uint64_t step_ns = simclock_wall_ns(1000000000ull / (uint64_t)speed);
+    uint64_t update_ns = simclock_wall_ns((uint64_t)update_ms * 1000000ull);
+    uint64_t next_tick = start, next_report = start + 1000000000ull, report_from = start;
+    LoadStats reported = stats;
+    int launched = 0;
+
+    while (!stop_requested) {
+        uint64_t now = now_ns();
+        if (now >= end) break;
+        int timeout = next_tick > now ? (int)((next_tick - now) / 1000000) : 0;
+        int n = epoll_wait(epfd, events, 256, timeout);
+        now = now_ns();
+        for (int i = 0; i < n; i++) {
+            SimDrone *d = events[i].data.ptr;
+            if (d->state == SIM_CONNECTING) {
+                connect_done(d);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) read_frames(d, now);
+            if (d->fd >= 0 && (events[i].events & EPOLLOUT)) flush_out(d);
+        }
+        if (now < next_tick) continue;
+        next_tick = now + LOADGEN_TICK_MS * 1000000ull;
+
+        // Connection ramp: as many as are due by now
+        int due = ramp ? (int)((now - start) * (uint64_t)ramp / 1000000000ull) + 1 : count;
+        while (launched < count && launched < due) start_connect(&fleet[launched++]);
+
+        for (int i = 0; i < launched; i++) {
+            SimDrone *d = &fleet[i];
+            if (d->state != SIM_IDLE && d->state != SIM_MISSION) continue;
+            step(d, now, step_ns);
+            if (d->fd >= 0 && now >= d->next_update_ns) {
+                d->next_update_ns = now + update_ns;
+                send_status(d);
+            }
+        }
+        if (now >= next_report) {
+            print_rates(&stats, &reported, (double)(now - report_from) / 1e9);
+            reported = stats;
+            report_from = now;
+            next_report = now + 1000000000ull;
+        }
+    }
+
+    double elapsed = (double)(now_ns() - start) / 1e9;
+    int unanswered = 0;
+    for (int i = 0; i < count; i++) unanswered += fleet[i].state == SIM_HANDSHAKE;
+    printf("\n[LOAD] Summary after %.1f s, %d of %d drones connected, %llu rejected by the server, %d still waiting for HANDSHAKE_ACK\n",
+           elapsed, connected, count, (unsigned long long)stats.rejected, unanswered);
+    for (int k = 0; k < TX_KINDS; k++)
+        printf("  sent %-18s %10llu  (%.1f/s)\n", tx_names[k], (unsigned long long)stats.tx[k], (double)stats.tx[k] / elapsed);
+    printf("  received ASSIGN_MISSION %llu, HEARTBEAT %llu, HANDSHAKE_ACK %llu, other %llu\n",
+           (unsigned long long)stats.rx_assign, (unsigned long long)stats.rx_heartbeat,
+           (unsigned long long)stats.rx_ack, (unsigned long long)stats.rx_other);
+    printf("  missions completed %llu, connect failures %llu, disconnects %llu\n",
+           (unsigned long long)stats.missions_completed, (unsigned long long)stats.connect_failures,
+           (unsigned long long)stats.disconnects);
+    if (assign_latency.count)
+        printf("  idle -> ASSIGN_MISSION latency: p50 %.3f s, p90 %.3f s, p99 %.3f s, max %.3f s (%llu missions)\n",
+               histogram_percentile(&assign_latency, 0.5) / 1e9, histogram_percentile(&assign_latency, 0.9) / 1e9,
+               histogram_percentile(&assign_latency, 0.99) / 1e9, assign_latency.max / 1e9,
+               (unsigned long long)assign_latency.count);
+
+    for (int i = 0; i < count; i++) close_drone(&fleet[i]);
+    close(epfd);
+    free(events);
+    free(fleet);
+    return EXIT_SUCCESS;
+}
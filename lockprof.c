@@ -0,0 +1,119 @@
+// Lock contention profiler, see headers/lockprof.h
+#include "headers/lockprof.h"
+
+#ifdef LOCK_PROFILING
+
+#include <stdlib.h>
+#include "headers/timer.h"
+
+typedef struct {
+    pthread_mutex_t *mutex;
+    uint64_t acquired_ns;   // written only by the holder
+    LockStats stats;        // written only by the holder, read relaxed
+} ProfiledLock;
+
+// Names are registered at startup; lookups never lock
+static ProfiledLock locks[LOCKPROF_MAX_LOCKS];
+static int lock_count;
+static pthread_mutex_t register_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static ProfiledLock *find_lock(pthread_mutex_t *mutex) {
+    int count = __atomic_load_n(&lock_count, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        if (locks[i].mutex == mutex) return &locks[i];
+    }
+    return NULL;
+}
+
+void lockprof_name(pthread_mutex_t *mutex, const char *name) {
+    pthread_mutex_lock(&register_mutex);
+    if (!find_lock(mutex) && lock_count < LOCKPROF_MAX_LOCKS) {
+        ProfiledLock *lock = &locks[lock_count];
+        lock->mutex = mutex;
+        lock->stats.name = name;
+        __atomic_store_n(&lock_count, lock_count + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&register_mutex);
+}
+
+// Called with the mutex held: the holder is the only writer of its stats
+static void acquired(ProfiledLock *lock, uint64_t requested_ns, uint64_t now, int contended) {
+    lock->acquired_ns = now;
+    __atomic_store_n(&lock->stats.acquisitions, lock->stats.acquisitions + 1, __ATOMIC_RELAXED);
+    if (contended) __atomic_store_n(&lock->stats.contended, lock->stats.contended + 1, __ATOMIC_RELAXED);
+    histogram_record_relaxed(&lock->stats.wait, now - requested_ns);
+}
+
+static void releasing(ProfiledLock *lock) {
+    histogram_record_relaxed(&lock->stats.hold, monotonic_ns() - lock->acquired_ns);
+}
+
+int lockprof_lock(pthread_mutex_t *mutex) {
+    ProfiledLock *lock = find_lock(mutex);
+    if (!lock) return pthread_mutex_lock(mutex);
+    uint64_t requested = monotonic_ns();
+    // Uncontended fast path tells contended acquisitions apart
+    if (pthread_mutex_trylock(mutex) == 0) {
+        acquired(lock, requested, monotonic_ns(), 0);
+        return 0;
+    }
+    int rc = pthread_mutex_lock(mutex);
+    if (rc == 0) acquired(lock, requested, monotonic_ns(), 1);
+    return rc;
+}
+
+int lockprof_unlock(pthread_mutex_t *mutex) {
+    ProfiledLock *lock = find_lock(mutex);
+    if (lock) releasing(lock);
+    return pthread_mutex_unlock(mutex);
+}
+
+// The wait on the condition is neither hold nor contention: close the hold
+// before sleeping and start a fresh one on wakeup
+int lockprof_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
+    ProfiledLock *lock = find_lock(mutex);
+    if (lock) releasing(lock);
+    int rc = pthread_cond_wait(cond, mutex);
+    if (lock) lock->acquired_ns = monotonic_ns();
+    return rc;
+}
+
+int lockprof_snapshot(LockStats *out, int max) {
+    int count = __atomic_load_n(&lock_count, __ATOMIC_ACQUIRE);
+    if (count > max) count = max;
+    for (int i = 0; i < count; i++) {
+        const LockStats *src = &locks[i].stats;
+        LockStats *dst = &out[i];
+        dst->name = src->name;
+        dst->acquisitions = __atomic_load_n(&src->acquisitions, __ATOMIC_RELAXED);
+        dst->contended = __atomic_load_n(&src->contended, __ATOMIC_RELAXED);
+        histogram_init(&dst->wait);
+        histogram_init(&dst->hold);
+        histogram_merge_relaxed(&dst->wait, &src->wait);
+        histogram_merge_relaxed(&dst->hold, &src->hold);
+    }
+    return count;
+}
+
+void lockprof_report(FILE *out) {
+    LockStats *stats = malloc(sizeof(LockStats) * LOCKPROF_MAX_LOCKS);
+    if (!stats) return;
+    int count = lockprof_snapshot(stats, LOCKPROF_MAX_LOCKS);
+    fprintf(out, "[LOCKPROF] %-22s %10s %9s %10s %10s %10s %10s %10s %10s %12s\n",
+            "lock", "acquired", "contended", "wait p50", "wait p99", "wait max",
+            "hold p50", "hold p99", "hold max", "total wait");
+    for (int i = 0; i < count; i++) {
+        LockStats *s = &stats[i];
+        double contended = s->acquisitions ? 100.0 * s->contended / s->acquisitions : 0;
+        fprintf(out, "[LOCKPROF] %-22s %10llu %8.2f%% %8.1fus %8.1fus %8.1fus %8.1fus %8.1fus %8.1fus %10.3fms\n",
+                s->name, (unsigned long long)s->acquisitions, contended,
+                histogram_percentile(&s->wait, 0.50) / 1e3, histogram_percentile(&s->wait, 0.99) / 1e3,
+                s->wait.max / 1e3,
+                histogram_percentile(&s->hold, 0.50) / 1e3, histogram_percentile(&s->hold, 0.99) / 1e3,
+                s->hold.max / 1e3, s->wait.sum / 1e6);
+    }
+    fflush(out);
+    free(stats);
+}
+
+#endif // LOCK_PROFILING
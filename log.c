@@ -0,0 +1,415 @@
+// Asynchronous logger: each thread owns a single-producer ring of binary
+// records; the logger thread merges the rings by timestamp and formats.
+#include "headers/log.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <sys/types.h>
+#include <pthread.h>
+
+#define LOG_RECORD_SIZE 128
+
+typedef struct {
+    uint64_t timestamp_ns;
+    const char *format;
+    uint8_t module;
+    uint8_t level;
+    uint8_t used;               // bytes of args filled
+    uint8_t truncated;          // ran out of room before the last argument
+    unsigned char args[LOG_RECORD_SIZE - 20];
+} LogRecord;
+
+typedef struct log_ring {
+    uint64_t head;              // written by the owning thread
+    uint64_t tail;              // written by the logger thread
+    uint64_t dropped;           // written by the owning thread
+    uint64_t dropped_reported;  // logger thread only
+    int in_use;                 // owned by a live thread
+    struct log_ring *next;
+    LogRecord records[LOG_RING_SIZE];
+} LogRing;
+
+LogLevel log_levels[LOG_MODULE_COUNT] = {
+    [LOG_MOD_SERVER] = LOG_LEVEL_INFO,
+    [LOG_MOD_AI] = LOG_LEVEL_INFO,
+    [LOG_MOD_DRONE] = LOG_LEVEL_INFO,
+};
+
+static const char *module_names[LOG_MODULE_COUNT] = {
+    [LOG_MOD_SERVER] = "server",
+    [LOG_MOD_AI] = "ai",
+    [LOG_MOD_DRONE] = "drone",
+};
+
+static const char *level_names[] = {"error", "warn", "info", "debug"};
+
+static LogRing *rings;          // prepended under rings_mutex, never freed
+static pthread_mutex_t rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t ring_key;
+static pthread_once_t ring_once = PTHREAD_ONCE_INIT;
+static pthread_t logger;
+static int logger_running;
+static int logger_stop;
+// The logger thread blocks on wake_cond while every ring is empty; writers
+// only take wake_mutex when logger_sleeping says it is (or is about to be) waiting
+static pthread_mutex_t wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake_cond = PTHREAD_COND_INITIALIZER;
+static int logger_sleeping;
+
+// Thread exit: records not yet formatted stay in the ring and are drained
+// before the ring is handed to the next new thread
+static void release_ring(void *arg) {
+    LogRing *ring = arg;
+    pthread_mutex_lock(&rings_mutex);
+    ring->in_use = 0;
+    pthread_mutex_unlock(&rings_mutex);
+}
+
+static void create_ring_key(void) {
+    pthread_key_create(&ring_key, release_ring);
+}
+
+static LogRing *thread_ring(void) {
+    pthread_once(&ring_once, create_ring_key);
+    LogRing *ring = pthread_getspecific(ring_key);
+    if (ring) return ring;
+    pthread_mutex_lock(&rings_mutex);
+    for (ring = rings; ring && ring->in_use; ring = ring->next)
+        ;
+    if (!ring) {
+        ring = calloc(1, sizeof(LogRing));
+        if (ring) {
+            ring->next = rings;
+            __atomic_store_n(&rings, ring, __ATOMIC_RELEASE);
+        }
+    }
+    if (ring) ring->in_use = 1;
+    pthread_mutex_unlock(&rings_mutex);
+    if (ring) pthread_setspecific(ring_key, ring);
+    return ring;
+}
+
+// One printf conversion: "%" flags/width/precision, length, conversion
+typedef struct {
+    const char *options;        // after '%', up to the length modifier
+    int options_len;
+    char length;                // 0, 'H' (hh), 'h', 'l', 'q' (ll), 'j', 'z', 't', 'L'
+    char conversion;
+} Spec;
+
+// p points at '%'; returns the character after the conversion
+static const char *parse_spec(const char *p, Spec *spec) {
+    spec->options = ++p;
+    while (*p && strchr("-+ #0123456789.", *p)) p++;
+    spec->options_len = (int)(p - spec->options);
+    spec->length = 0;
+    if (*p == 'h') spec->length = p[1] == 'h' ? (p++, 'H') : 'h';
+    else if (*p == 'l') spec->length = p[1] == 'l' ? (p++, 'q') : 'l';
+    else if (*p && strchr("jztL", *p)) spec->length = *p;
+    if (spec->length) p++;
+    spec->conversion = *p;
+    return *p ? p + 1 : p;
+}
+
+static int put_value(LogRecord *rec, const void *value) {
+    if (rec->used + sizeof(uint64_t) > sizeof(rec->args)) return -1;
+    memcpy(rec->args + rec->used, value, sizeof(uint64_t));
+    rec->used += sizeof(uint64_t);
+    return 0;
+}
+
+static int put_string(LogRecord *rec, const char *s) {
+    if (!s) s = "(null)";
+    size_t room = sizeof(rec->args) - rec->used;
+    if (room < 1) return -1;
+    size_t len = strlen(s);
+    if (len > room - 1) len = room - 1;
+    rec->args[rec->used++] = (unsigned char)len;
+    memcpy(rec->args + rec->used, s, len);
+    rec->used += len;
+    return 0;
+}
+
+static int64_t signed_arg(va_list *ap, char length) {
+    switch (length) {
+        case 'H': return (signed char)va_arg(*ap, int);
+        case 'h': return (short)va_arg(*ap, int);
+        case 'l': return va_arg(*ap, long);
+        case 'q': return va_arg(*ap, long long);
+        case 'j': return va_arg(*ap, intmax_t);
+        case 'z': return va_arg(*ap, ssize_t);
+        case 't': return va_arg(*ap, ptrdiff_t);
+        default: return va_arg(*ap, int);
+    }
+}
+
+static uint64_t unsigned_arg(va_list *ap, char length) {
+    switch (length) {
+        case 'H': return (unsigned char)va_arg(*ap, unsigned int);
+        case 'h': return (unsigned short)va_arg(*ap, unsigned int);
+        case 'l': return va_arg(*ap, unsigned long);
+        case 'q': return va_arg(*ap, unsigned long long);
+        case 'j': return va_arg(*ap, uintmax_t);
+        case 'z': return va_arg(*ap, size_t);
+        case 't': return va_arg(*ap, ptrdiff_t);
+        default: return va_arg(*ap, unsigned int);
+    }
+}
+
+void log_write(LogModule module, LogLevel level, const char *format, ...) {
+    LogRing *ring = thread_ring();
+    if (!ring) return;
+    uint64_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= LOG_RING_SIZE) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+    LogRecord *rec = &ring->records[head % LOG_RING_SIZE];
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    rec->timestamp_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    rec->format = format;
+    rec->module = (uint8_t)module;
+    rec->level = (uint8_t)level;
+    rec->used = 0;
+    rec->truncated = 0;
+
+    va_list ap;
+    va_start(ap, format);
+    for (const char *p = format; (p = strchr(p, '%')) != NULL && !rec->truncated;) {
+        Spec spec;
+        p = parse_spec(p, &spec);
+        int64_t i;
+        uint64_t u;
+        double d;
+        switch (spec.conversion) {
+            case 'd': case 'i': case 'c':
+                i = signed_arg(&ap, spec.length);
+                rec->truncated = put_value(rec, &i) != 0;
+                break;
+            case 'o': case 'u': case 'x': case 'X':
+                u = unsigned_arg(&ap, spec.length);
+                rec->truncated = put_value(rec, &u) != 0;
+                break;
+            case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+                d = spec.length == 'L' ? (double)va_arg(ap, long double) : va_arg(ap, double);
+                rec->truncated = put_value(rec, &d) != 0;
+                break;
+            case 'p':
+                u = (uintptr_t)va_arg(ap, void *);
+                rec->truncated = put_value(rec, &u) != 0;
+                break;
+            case 's':
+                rec->truncated = put_string(rec, va_arg(ap, const char *)) != 0;
+                break;
+            case 'n':
+                (void)va_arg(ap, void *);
+                break;
+            default:            // "%%" or malformed: no argument
+                break;
+        }
+    }
+    va_end(ap);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    // pairs with the fence in wait_for_records: either the logger sees this
+    // record before it sleeps or we see it sleeping and wake it
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&logger_sleeping, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&wake_mutex);
+        pthread_cond_signal(&wake_cond);
+        pthread_mutex_unlock(&wake_mutex);
+    }
+}
+
+// Expand one record into buf (always NUL-terminated)
+static void format_record(const LogRecord *rec, char *buf, size_t size) {
+    size_t len = 0, pos = 0;
+    const char *p = rec->format;
+#define APPEND(...) do { \
+        int n_ = snprintf(buf + len, size - len, __VA_ARGS__); \
+        if (n_ > 0) len = len + (size_t)n_ < size ? len + (size_t)n_ : size - 1; \
+    } while (0)
+    while (*p) {
+        const char *pct = strchr(p, '%');
+        if (!pct) {
+            APPEND("%s", p);
+            break;
+        }
+        APPEND("%.*s", (int)(pct - p), p);
+        Spec spec;
+        p = parse_spec(pct, &spec);
+        // Re-issue the conversion with the width at which the value was stored
+        char conv[32];
+        const char *length = "";
+        if (spec.conversion && strchr("diouxX", spec.conversion)) length = "ll";
+        snprintf(conv, sizeof(conv), "%%%.*s%s%c", spec.options_len < 24 ? spec.options_len : 24,
+                 spec.options, length, spec.conversion);
+        int is_string = spec.conversion == 's';
+        int takes_value = spec.conversion && strchr("diouxXceEfFgGaAp", spec.conversion);
+        if (!is_string && !takes_value) {
+            if (spec.conversion == '%') APPEND("%%");
+            continue;
+        }
+        if (is_string ? pos >= rec->used : pos + sizeof(uint64_t) > rec->used) {
+            APPEND("...");
+            break;
+        }
+        if (is_string) {
+            char s[sizeof(rec->args)];
+            size_t n = rec->args[pos++];
+            memcpy(s, rec->args + pos, n);
+            s[n] = '\0';
+            pos += n;
+            APPEND(conv, s);
+            continue;
+        }
+        uint64_t raw;
+        memcpy(&raw, rec->args + pos, sizeof(raw));
+        pos += sizeof(raw);
+        switch (spec.conversion) {
+            case 'd': case 'i': APPEND(conv, (long long)raw); break;
+            case 'c': APPEND(conv, (int)raw); break;
+            case 'p': APPEND(conv, (void *)(uintptr_t)raw); break;
+            case 'o': case 'u': case 'x': case 'X': APPEND(conv, (unsigned long long)raw); break;
+            default: {
+                double d;
+                memcpy(&d, &raw, sizeof(d));
+                APPEND(conv, d);
+            }
+        }
+    }
+    if (rec->truncated && (len == 0 || buf[len - 1] != '\n')) APPEND("\n");
+#undef APPEND
+}
+
+// Format everything published so far, oldest first across threads
+static size_t drain(void) {
+    size_t written = 0;
+    LogRing *list = __atomic_load_n(&rings, __ATOMIC_ACQUIRE);
+    for (LogRing *ring = list; ring; ring = ring->next) {
+        uint64_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        if (dropped != ring->dropped_reported) {
+            fprintf(stderr, "[LOG] %llu messages dropped (ring full)\n",
+                    (unsigned long long)(dropped - ring->dropped_reported));
+            ring->dropped_reported = dropped;
+            written++;
+        }
+    }
+    char line[1024];
+    for (;;) {
+        LogRing *oldest = NULL;
+        const LogRecord *next = NULL;
+        for (LogRing *ring = list; ring; ring = ring->next) {
+            uint64_t tail = ring->tail;
+            if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) continue;
+            const LogRecord *rec = &ring->records[tail % LOG_RING_SIZE];
+            if (!next || rec->timestamp_ns < next->timestamp_ns) {
+                oldest = ring;
+                next = rec;
+            }
+        }
+        if (!next) break;
+        format_record(next, line, sizeof(line));
+        fputs(line, next->level <= LOG_LEVEL_WARN ? stderr : stdout);
+        __atomic_store_n(&oldest->tail, oldest->tail + 1, __ATOMIC_RELEASE);
+        written++;
+    }
+    if (written) fflush(stdout);
+    return written;
+}
+
+static int records_pending(void) {
+    for (LogRing *ring = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        if (ring->tail != __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) return 1;
+    }
+    return 0;
+}
+
+// Block until a writer publishes a record or shutdown is requested, so an
+// idle process costs no wakeups
+static void wait_for_records(void) {
+    pthread_mutex_lock(&wake_mutex);
+    __atomic_store_n(&logger_sleeping, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while (!records_pending() && !__atomic_load_n(&logger_stop, __ATOMIC_ACQUIRE))
+        pthread_cond_wait(&wake_cond, &wake_mutex);
+    __atomic_store_n(&logger_sleeping, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&wake_mutex);
+}
+
+static void *logger_thread(void *arg) {
+    (void)arg;
+    for (;;) {
+        int stopping = __atomic_load_n(&logger_stop, __ATOMIC_ACQUIRE);
+        if (drain() == 0) {
+            if (stopping) break;
+            wait_for_records();
+        }
+    }
+    return NULL;
+}
+
+static void log_shutdown(void) {
+    if (!logger_running) return;
+    pthread_mutex_lock(&wake_mutex);
+    __atomic_store_n(&logger_stop, 1, __ATOMIC_RELEASE);
+    pthread_cond_signal(&wake_cond);
+    pthread_mutex_unlock(&wake_mutex);
+    if (!pthread_equal(pthread_self(), logger)) pthread_join(logger, NULL);
+    logger_running = 0;
+}
+
+static int parse_level(const char *s, size_t len, LogLevel *level) {
+    for (size_t i = 0; i < sizeof(level_names) / sizeof(level_names[0]); i++) {
+        if (strlen(level_names[i]) == len && strncasecmp(s, level_names[i], len) == 0) {
+            *level = (LogLevel)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// "level" sets every module, "module=level" one of them; comma separated
+static void configure(const char *spec) {
+    while (*spec) {
+        size_t len = strcspn(spec, ",");
+        const char *eq = memchr(spec, '=', len);
+        LogLevel level;
+        if (!eq) {
+            if (parse_level(spec, len, &level) == 0) {
+                for (int m = 0; m < LOG_MODULE_COUNT; m++) log_levels[m] = level;
+            } else {
+                fprintf(stderr, "LOG_LEVEL: unknown level '%.*s'\n", (int)len, spec);
+            }
+        } else {
+            size_t name_len = (size_t)(eq - spec);
+            int module = -1;
+            for (int m = 0; m < LOG_MODULE_COUNT; m++) {
+                if (strlen(module_names[m]) == name_len && strncasecmp(spec, module_names[m], name_len) == 0) module = m;
+            }
+            if (module < 0 || parse_level(eq + 1, len - name_len - 1, &level) != 0) {
+                fprintf(stderr, "LOG_LEVEL: ignoring '%.*s'\n", (int)len, spec);
+            } else {
+                log_levels[module] = level;
+            }
+        }
+        spec += len;
+        if (*spec == ',') spec++;
+    }
+}
+
+void log_init(void) {
+    const char *spec = getenv("LOG_LEVEL");
+    if (spec) configure(spec);
+    if (logger_running) return;
+    if (pthread_create(&logger, NULL, logger_thread, NULL) != 0) {
+        perror("Failed to create logger thread");
+        return;
+    }
+    logger_running = 1;
+    atexit(log_shutdown);
+}
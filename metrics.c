@@ -0,0 +1,109 @@
+// Metrics registry. Each thread writes into its own shard; a snapshot sums
+// the shards. The registry lock is only taken when a thread creates or
+// retires its shard and when a snapshot is read, never on the write path.
+#include "headers/metrics.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define METRIC_DESC(id, name, labels, help) { name, labels, help },
+const MetricDesc counter_desc[COUNTER_COUNT] = { METRIC_COUNTERS(METRIC_DESC) };
+const MetricDesc gauge_desc[GAUGE_COUNT] = { METRIC_GAUGES(METRIC_DESC) };
+const MetricDesc histogram_desc[HISTOGRAM_COUNT] = { METRIC_HISTOGRAMS(METRIC_DESC) };
+#undef METRIC_DESC
+
+typedef struct metrics_shard {
+    uint64_t counters[COUNTER_COUNT];
+    Histogram histograms[HISTOGRAM_COUNT];
+    struct metrics_shard *next;
+} MetricsShard;
+
+static MetricsShard *shards;        // live threads
+static MetricsShard retired;        // totals of threads that exited
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t shard_key;
+static pthread_once_t shard_once = PTHREAD_ONCE_INIT;
+
+static int64_t gauges[GAUGE_COUNT];
+
+// Only the owning thread writes a shard, so a relaxed load and store is
+// enough (no locked instruction); readers may see a value one update old.
+// Histograms use the matching histogram_*_relaxed helpers.
+#define SHARD_ADD(field, value) \
+    __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+#define SHARD_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+
+static void merge_shard(MetricsShard *dst, MetricsShard *src) {
+    for (int i = 0; i < COUNTER_COUNT; i++) dst->counters[i] += SHARD_LOAD(src->counters[i]);
+    for (int i = 0; i < HISTOGRAM_COUNT; i++) histogram_merge_relaxed(&dst->histograms[i], &src->histograms[i]);
+}
+
+// Thread exit: fold the shard into the retired totals
+static void retire_shard(void *arg) {
+    MetricsShard *shard = arg;
+    pthread_mutex_lock(&registry_mutex);
+    for (MetricsShard **p = &shards; *p; p = &(*p)->next) {
+        if (*p == shard) {
+            *p = shard->next;
+            break;
+        }
+    }
+    merge_shard(&retired, shard);
+    pthread_mutex_unlock(&registry_mutex);
+    free(shard);
+}
+
+static void create_shard_key(void) {
+    pthread_key_create(&shard_key, retire_shard);
+}
+
+static MetricsShard *thread_shard(void) {
+    pthread_once(&shard_once, create_shard_key);
+    MetricsShard *shard = pthread_getspecific(shard_key);
+    if (shard) return shard;
+    // Cache-line aligned so two threads never write the same line
+    void *mem = NULL;
+    if (posix_memalign(&mem, 64, sizeof(MetricsShard)) != 0) return NULL;
+    shard = mem;
+    memset(shard, 0, sizeof(*shard));
+    pthread_setspecific(shard_key, shard);
+    pthread_mutex_lock(&registry_mutex);
+    shard->next = shards;
+    shards = shard;
+    pthread_mutex_unlock(&registry_mutex);
+    return shard;
+}
+
+void metrics_add(CounterId id, uint64_t value) {
+    MetricsShard *shard = thread_shard();
+    if (shard) SHARD_ADD(shard->counters[id], value);
+}
+
+void metrics_inc(CounterId id) {
+    metrics_add(id, 1);
+}
+
+void metrics_observe(HistogramId id, uint64_t value) {
+    MetricsShard *shard = thread_shard();
+    if (shard) histogram_record_relaxed(&shard->histograms[id], value);
+}
+
+void metrics_gauge_set(GaugeId id, int64_t value) {
+    __atomic_store_n(&gauges[id], value, __ATOMIC_RELAXED);
+}
+
+void metrics_gauge_add(GaugeId id, int64_t delta) {
+    __atomic_fetch_add(&gauges[id], delta, __ATOMIC_RELAXED);
+}
+
+void metrics_snapshot(MetricsSnapshot *snapshot) {
+    MetricsShard total;
+    memset(&total, 0, sizeof(total));
+    pthread_mutex_lock(&registry_mutex);
+    merge_shard(&total, &retired);
+    for (MetricsShard *shard = shards; shard; shard = shard->next) merge_shard(&total, shard);
+    pthread_mutex_unlock(&registry_mutex);
+    memcpy(snapshot->counters, total.counters, sizeof(snapshot->counters));
+    memcpy(snapshot->histograms, total.histograms, sizeof(snapshot->histograms));
+    for (int i = 0; i < GAUGE_COUNT; i++) snapshot->gauges[i] = __atomic_load_n(&gauges[i], __ATOMIC_RELAXED);
+}
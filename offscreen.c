@@ -0,0 +1,454 @@
+// Offscreen renderer: rasterizes a WorldSnapshot into an RGB buffer with the
+// SDL view's colors and layout, then encodes PPM or PNG. The PNG encoder is
+// self-contained: fixed-Huffman deflate whose matches only look one pixel
+// back and one row up, which is where this imagery (flat cells on black)
+// repeats, so frames stay small without zlib.
+#include "headers/offscreen.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "headers/snapshot.h"
+#include "headers/drone.h"
+#include "headers/globals.h"
+#include "headers/log.h"
+#include "headers/lockprof.h"
+
+#define CELL_SIZE 20            // same as the SDL view at its default zoom
+#define GRID_MIN_PX 8
+
+typedef struct { uint8_t r, g, b; } Rgb;
+
+static const Rgb RED = {255, 0, 0};
+static const Rgb ORANGE = {255, 165, 0};
+static const Rgb PURPLE = {128, 0, 128};
+static const Rgb BLUE = {0, 0, 255};
+static const Rgb GREEN = {0, 255, 0};
+static const Rgb YELLOW = {255, 255, 0};
+static const Rgb WHITE = {255, 255, 255};
+
+typedef struct {
+    uint8_t *data;
+    size_t len, capacity;
+} ByteBuffer;
+
+// Scratch state, reused across frames
+static pthread_mutex_t render_mutex = PTHREAD_MUTEX_INITIALIZER;
+static WorldSnapshot world;
+static uint8_t *pixels;
+static int width, height;
+static size_t pixels_capacity;
+static ByteBuffer raw, compressed;
+
+static int buffer_reserve(ByteBuffer *b, size_t extra) {
+    if (b->len + extra <= b->capacity) return 0;
+    size_t capacity = b->capacity ? b->capacity : 4096;
+    while (capacity < b->len + extra) capacity *= 2;
+    uint8_t *data = realloc(b->data, capacity);
+    if (!data) return -1;
+    b->data = data;
+    b->capacity = capacity;
+    return 0;
+}
+
+// --- Rasterizer ---
+
+static void fill_rect(int x, int y, int w, int h, Rgb c) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > width) w = width - x;
+    if (y + h > height) h = height - y;
+    for (int row = y; row < y + h; row++) {
+        uint8_t *p = pixels + ((size_t)row * width + x) * 3;
+        for (int col = 0; col < w; col++, p += 3) {
+            p[0] = c.r;
+            p[1] = c.g;
+            p[2] = c.b;
+        }
+    }
+}
+
+static void draw_line(int x0, int y0, int x1, int y1, Rgb c) {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        fill_rect(x0, y0, 1, 1, c);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+// Same scene as draw_map: survivors, drones with target crosses and
+// mission lines, grid on top. Maps too big for OFFSCREEN_MAX_PX at one
+// pixel per cell are scaled down to one pixel per block of cells.
+static int render(const WorldSnapshot *snap) {
+    int longest = snap->map_width > snap->map_height ? snap->map_width : snap->map_height;
+    if (longest <= 0) return -1;
+    int cell = OFFSCREEN_MAX_PX / longest;
+    if (cell > CELL_SIZE) cell = CELL_SIZE;
+    int cells_per_px = 1;
+    if (cell < 1) {
+        cell = 1;
+        cells_per_px = (longest + OFFSCREEN_MAX_PX - 1) / OFFSCREEN_MAX_PX;
+    }
+    width = (snap->map_width + cells_per_px - 1) / cells_per_px * cell;
+    height = (snap->map_height + cells_per_px - 1) / cells_per_px * cell;
+    size_t size = (size_t)width * height * 3;
+    if (size > pixels_capacity) {
+        uint8_t *p = realloc(pixels, size);
+        if (!p) return -1;
+        pixels = p;
+        pixels_capacity = size;
+    }
+    memset(pixels, 0, size);
+
+    for (int i = 0; i < snap->survivor_count; i++) {
+        const SnapshotSurvivor *s = &snap->survivors[i];
+        Rgb c = s->kind == SNAP_SURVIVOR_PRIORITY ? ORANGE : s->kind == SNAP_SURVIVOR_HELPED ? PURPLE : RED;
+        fill_rect(s->coord.y / cells_per_px * cell, s->coord.x / cells_per_px * cell, cell, cell, c);
+    }
+    for (int i = 0; i < snap->drone_count; i++) {
+        const SnapshotDrone *d = &snap->drones[i];
+        fill_rect(d->coord.y / cells_per_px * cell, d->coord.x / cells_per_px * cell, cell, cell,
+                  d->status == IDLE ? BLUE : GREEN);
+    }
+    if (cell >= GRID_MIN_PX) {
+        int half = cell / 2, size = cell / 4;
+        for (int i = 0; i < snap->drone_count; i++) {
+            const SnapshotDrone *d = &snap->drones[i];
+            int cx = d->target.y * cell + half, cy = d->target.x * cell + half;
+            fill_rect(cx - size, cy, 2 * size + 1, 1, YELLOW);
+            fill_rect(cx, cy - size, 1, 2 * size + 1, YELLOW);
+        }
+        for (int i = 0; i < snap->drone_count; i++) {
+            const SnapshotDrone *d = &snap->drones[i];
+            if (d->status != ON_MISSION) continue;
+            draw_line(d->coord.y * cell + half, d->coord.x * cell + half,
+                      d->target.y * cell + half, d->target.x * cell + half, GREEN);
+        }
+        for (int y = 0; y < height; y += cell) fill_rect(0, y, width, 1, WHITE);
+        for (int x = 0; x < width; x += cell) fill_rect(x, 0, 1, height, WHITE);
+    }
+    return 0;
+}
+
+// --- PNG encoder ---
+
+static uint32_t crc_table[256];
+
+static void init_crc_table(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        crc_table[n] = c;
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+typedef struct {
+    ByteBuffer *out;
+    uint32_t bits;
+    int count;
+} BitWriter;
+
+// Deflate packs fields starting from the least significant bit
+static void put_bits(BitWriter *w, uint32_t value, int n) {
+    w->bits |= value << w->count;
+    w->count += n;
+    while (w->count >= 8) {
+        if (buffer_reserve(w->out, 1) == 0) w->out->data[w->out->len++] = (uint8_t)w->bits;
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+// Huffman codes go most significant bit first
+static void put_code(BitWriter *w, uint32_t code, int n) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < n; i++) reversed |= ((code >> i) & 1) << (n - 1 - i);
+    put_bits(w, reversed, n);
+}
+
+// Fixed literal/length code (RFC 1951, 3.2.6)
+static void put_symbol(BitWriter *w, int sym) {
+    if (sym < 144) put_code(w, 0x30 + sym, 8);
+    else if (sym < 256) put_code(w, 0x190 + sym - 144, 9);
+    else if (sym < 280) put_code(w, sym - 256, 7);
+    else put_code(w, 0xc0 + sym - 280, 8);
+}
+
+static const uint16_t length_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t distance_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+                                           513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t distance_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+                                           8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static void put_match(BitWriter *w, int length, int distance) {
+    int l = 28;
+    while (length_base[l] > length) l--;
+    put_symbol(w, 257 + l);
+    put_bits(w, (uint32_t)(length - length_base[l]), length_extra[l]);
+    int d = 29;
+    while (distance_base[d] > distance) d--;
+    put_code(w, (uint32_t)d, 5);
+    put_bits(w, (uint32_t)(distance - distance_base[d]), distance_extra[d]);
+}
+
+static int match_length(const uint8_t *data, size_t pos, size_t len, size_t distance) {
+    if (distance > pos) return 0;
+    size_t max = len - pos < 258 ? len - pos : 258;
+    size_t n = 0;
+    while (n < max && data[pos + n] == data[pos + n - distance]) n++;
+    return (int)n;
+}
+
+// zlib stream of data (one fixed-Huffman block) into out
+static int zlib_compress(const uint8_t *data, size_t len, size_t row_stride, ByteBuffer *out) {
+    out->len = 0;
+    if (buffer_reserve(out, 2) < 0) return -1;
+    out->data[out->len++] = 0x78;
+    out->data[out->len++] = 0x01;
+    BitWriter w = { out, 0, 0 };
+    put_bits(&w, 1, 1);         // final block
+    put_bits(&w, 1, 2);         // fixed Huffman
+    size_t distances[2] = { 3, row_stride };
+    for (size_t pos = 0; pos < len;) {
+        int best = 0;
+        size_t best_distance = 0;
+        for (int i = 0; i < 2; i++) {
+            if (distances[i] > 32768) continue;
+            int n = match_length(data, pos, len, distances[i]);
+            if (n > best) {
+                best = n;
+                best_distance = distances[i];
+            }
+        }
+        if (best >= 3) {
+            put_match(&w, best, (int)best_distance);
+            pos += (size_t)best;
+        } else {
+            put_symbol(&w, data[pos++]);
+        }
+    }
+    put_symbol(&w, 256);
+    put_bits(&w, 0, 7);         // pad to a byte boundary
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < len; i++) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    if (buffer_reserve(out, 4) < 0) return -1;
+    for (int i = 3; i >= 0; i--) out->data[out->len++] = (uint8_t)(adler >> (8 * i));
+    return 0;
+}
+
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void write_chunk(FILE *out, const char *type, const uint8_t *data, size_t len) {
+    uint8_t header[8];
+    put_be32(header, (uint32_t)len);
+    memcpy(header + 4, type, 4);
+    uint32_t crc = crc32_update(0xffffffffu, header + 4, 4);
+    crc = crc32_update(crc, data, len) ^ 0xffffffffu;
+    uint8_t trailer[4];
+    put_be32(trailer, crc);
+    fwrite(header, 1, 8, out);
+    fwrite(data, 1, len, out);
+    fwrite(trailer, 1, 4, out);
+}
+
+static int write_png(FILE *out) {
+    static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+    pthread_once(&crc_once, init_crc_table);
+    // Each scanline is prefixed with filter type 0 (none)
+    size_t stride = (size_t)width * 3 + 1;
+    raw.len = 0;
+    if (buffer_reserve(&raw, stride * height) < 0) return -1;
+    for (int y = 0; y < height; y++) {
+        raw.data[raw.len++] = 0;
+        memcpy(raw.data + raw.len, pixels + (size_t)y * width * 3, (size_t)width * 3);
+        raw.len += (size_t)width * 3;
+    }
+    if (zlib_compress(raw.data, raw.len, stride, &compressed) < 0) return -1;
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    uint8_t ihdr[13];
+    put_be32(ihdr, (uint32_t)width);
+    put_be32(ihdr + 4, (uint32_t)height);
+    ihdr[8] = 8;                // bits per channel
+    ihdr[9] = 2;                // truecolor RGB
+    ihdr[10] = ihdr[11] = ihdr[12] = 0;
+    fwrite(signature, 1, sizeof(signature), out);
+    write_chunk(out, "IHDR", ihdr, sizeof(ihdr));
+    write_chunk(out, "IDAT", compressed.data, compressed.len);
+    write_chunk(out, "IEND", NULL, 0);
+    return ferror(out) ? -1 : 0;
+}
+
+static int write_ppm(FILE *out) {
+    fprintf(out, "P6\n%d %d\n255\n", width, height);
+    fwrite(pixels, 1, (size_t)width * height * 3, out);
+    return ferror(out) ? -1 : 0;
+}
+
+int offscreen_write_frame(FILE *out, FrameFormat format) {
+    mutex_lock(&render_mutex);
+    snapshot_capture(&world);
+    int rc = render(&world);
+    if (rc == 0) rc = format == FRAME_PNG ? write_png(out) : write_ppm(out);
+    mutex_unlock(&render_mutex);
+    return rc;
+}
+
+// --- Frames for the admin endpoint ---
+// Rendered on a thread of their own so the poll() loop that serves them,
+// and accepts drones, never waits on a capture or an encode. Requests that
+// arrive while a frame is being rendered are answered by the next one.
+
+typedef struct {
+    unsigned long requested;    // sequence number of the newest request
+    unsigned long done;         // request the current data answers
+    int rc;
+    char *data;
+    size_t len;
+} FrameSlot;
+
+static pthread_mutex_t service_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t service_cond = PTHREAD_COND_INITIALIZER;
+static FrameSlot slots[FRAME_PNG + 1];
+static int notify_pipe[2] = {-1, -1};   // a byte per finished frame, read by the admin loop
+
+static void *frame_service_thread(void *arg) {
+    mutex_lock(&service_mutex);
+    while (running) {
+        int format = -1;
+        for (int f = 0; f <= FRAME_PNG; f++) {
+            if (slots[f].requested != slots[f].done) format = f;
+        }
+        if (format < 0) {
+            pthread_cond_wait(&service_cond, &service_mutex);
+            continue;
+        }
+        unsigned long seq = slots[format].requested;
+        mutex_unlock(&service_mutex);
+        char *data = NULL;
+        size_t len = 0;
+        FILE *out = open_memstream(&data, &len);
+        int rc = out ? offscreen_write_frame(out, (FrameFormat)format) : -1;
+        if (out) fclose(out);
+        mutex_lock(&service_mutex);
+        free(slots[format].data);
+        slots[format].data = data;
+        slots[format].len = len;
+        slots[format].rc = rc;
+        slots[format].done = seq;
+        // EAGAIN means a wakeup is already pending in the pipe
+        ssize_t n = write(notify_pipe[1], "", 1);
+        (void)n;
+    }
+    mutex_unlock(&service_mutex);
+    return NULL;
+}
+
+// Caller holds service_mutex
+static int frame_service_start(void) {
+    if (notify_pipe[0] >= 0) return 0;
+    int fds[2];
+    if (pipe(fds) < 0) return -1;
+    for (int i = 0; i < 2; i++) fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, frame_service_thread, NULL) != 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    pthread_detach(tid);
+    notify_pipe[0] = fds[0];
+    notify_pipe[1] = fds[1];
+    return 0;
+}
+
+int offscreen_request(FrameFormat format, unsigned long *seq) {
+    mutex_lock(&service_mutex);
+    int rc = frame_service_start();
+    if (rc == 0) {
+        *seq = ++slots[format].requested;
+        pthread_cond_signal(&service_cond);
+    }
+    mutex_unlock(&service_mutex);
+    return rc;
+}
+
+int offscreen_notify_fd(void) {
+    return notify_pipe[0];
+}
+
+int offscreen_collect(FrameFormat format, unsigned long seq, char **data, size_t *len) {
+    int ready = 0;
+    mutex_lock(&service_mutex);
+    FrameSlot *slot = &slots[format];
+    if ((long)(slot->done - seq) >= 0) {
+        ready = slot->rc == 0 ? 1 : -1;
+        *data = ready > 0 ? malloc(slot->len) : NULL;
+        if (ready > 0 && !*data) ready = -1;
+        if (ready > 0) {
+            memcpy(*data, slot->data, slot->len);
+            *len = slot->len;
+        }
+    }
+    mutex_unlock(&service_mutex);
+    return ready;
+}
+
+// --- Timelapse writer ---
+
+static int frame_interval;
+
+static void *frame_writer_thread(void *arg) {
+    long started = (long)time(NULL);
+    unsigned int frame = 0;
+    while (running) {
+        sleep((unsigned int)frame_interval);
+        char path[96];
+        snprintf(path, sizeof(path), "%s/frame-%ld-%06u.png", OFFSCREEN_DIR, started, frame++);
+        FILE *out = fopen(path, "wb");
+        if (!out) {
+            log_warn(LOG_MOD_SERVER, "[SERVER] Cannot write frame %s\n", path);
+            continue;
+        }
+        if (offscreen_write_frame(out, FRAME_PNG) != 0) log_warn(LOG_MOD_SERVER, "[SERVER] Failed to render frame %s\n", path);
+        fclose(out);
+    }
+    return NULL;
+}
+
+void offscreen_start(int interval_s) {
+    if (interval_s <= 0) return;
+    frame_interval = interval_s;
+    mkdir(OFFSCREEN_DIR, 0755);
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, frame_writer_thread, NULL) != 0) {
+        perror("Failed to create frame writer thread");
+        return;
+    }
+    pthread_detach(tid);
+}
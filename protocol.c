@@ -0,0 +1,247 @@
+// Newline-delimited JSON framing shared by the server and the drone client
+#include "headers/protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+static pthread_key_t print_buffer_key;
+static pthread_once_t print_buffer_once = PTHREAD_ONCE_INIT;
+
+static void free_print_buffer(void *arg) {
+    PrintBuffer *buf = arg;
+    cJSON_free(buf->data);
+    free(buf);
+}
+
+static void create_print_buffer_key(void) {
+    pthread_key_create(&print_buffer_key, free_print_buffer);
+}
+
+PrintBuffer *thread_print_buffer(void) {
+    pthread_once(&print_buffer_once, create_print_buffer_key);
+    PrintBuffer *buf = pthread_getspecific(print_buffer_key);
+    if (!buf) {
+        buf = calloc(1, sizeof(PrintBuffer));
+        if (!buf) return NULL;
+        pthread_setspecific(print_buffer_key, buf);
+    }
+    return buf;
+}
+
+size_t print_json_frame(cJSON *json, PrintBuffer *buf) {
+    return cJSON_PrintReusable(json, &buf->data, &buf->capacity, 0, "\n");
+}
+
+int send_all(int sockfd, const char *data, size_t len) {
+    size_t total = 0;
+    while (total < len) {
+        ssize_t sent = send(sockfd, data + total, len - total, MSG_NOSIGNAL);
+        if (sent <= 0) return -1;
+        total += (size_t)sent;
+    }
+    return 0;
+}
+
+int send_json(int sockfd, cJSON *json) {
+    PrintBuffer *buf = thread_print_buffer();
+    if (!buf) return -1;
+    size_t len = print_json_frame(json, buf);
+    if (len == 0) return -1;
+    return send_all(sockfd, buf->data, len);
+}
+
+FrameTemplate *frame_template_create(cJSON *json) {
+    PrintBuffer *buf = thread_print_buffer();
+    if (!buf) return NULL;
+    size_t len = print_json_frame(json, buf);
+    if (len == 0) return NULL;
+    FrameTemplate *tmpl = calloc(1, sizeof(FrameTemplate));
+    if (!tmpl) return NULL;
+    tmpl->text = malloc(len + 1);
+    if (!tmpl->text) { free(tmpl); return NULL; }
+    // Copy the rendered text, dropping each marker and remembering where it was
+    for (size_t i = 0; i < len; i++) {
+        if (buf->data[i] == FRAME_SLOT[0]) {
+            if (tmpl->slot_count == FRAME_TEMPLATE_MAX_SLOTS) {
+                frame_template_destroy(tmpl);
+                return NULL;
+            }
+            tmpl->slots[tmpl->slot_count++] = tmpl->length;
+            continue;
+        }
+        tmpl->text[tmpl->length++] = buf->data[i];
+    }
+    tmpl->text[tmpl->length] = '\0';
+    return tmpl;
+}
+
+void frame_template_destroy(FrameTemplate *tmpl) {
+    if (!tmpl) return;
+    free(tmpl->text);
+    free(tmpl);
+}
+
+static int print_buffer_reserve(PrintBuffer *buf, size_t needed) {
+    if (buf->capacity >= needed) return 0;
+    size_t capacity = buf->capacity ? buf->capacity : 256;
+    while (capacity < needed) capacity *= 2;
+    char *data = cJSON_malloc(capacity);
+    if (!data) return -1;
+    cJSON_free(buf->data);
+    buf->data = data;
+    buf->capacity = capacity;
+    return 0;
+}
+
+size_t frame_template_render(const FrameTemplate *tmpl, PrintBuffer *out, const char *const values[]) {
+    size_t value_lengths[FRAME_TEMPLATE_MAX_SLOTS];
+    size_t total = tmpl->length;
+    for (int i = 0; i < tmpl->slot_count; i++) {
+        value_lengths[i] = strlen(values[i]);
+        total += value_lengths[i];
+    }
+    if (print_buffer_reserve(out, total + 1) < 0) return 0;
+    size_t copied = 0, len = 0;
+    for (int i = 0; i < tmpl->slot_count; i++) {
+        memcpy(out->data + len, tmpl->text + copied, tmpl->slots[i] - copied);
+        len += tmpl->slots[i] - copied;
+        copied = tmpl->slots[i];
+        memcpy(out->data + len, values[i], value_lengths[i]);
+        len += value_lengths[i];
+    }
+    memcpy(out->data + len, tmpl->text + copied, tmpl->length - copied + 1);
+    return total;
+}
+
+void frame_reader_init(FrameReader *reader, int sockfd) {
+    reader->sockfd = sockfd;
+    reader->start = 0;
+    reader->end = 0;
+}
+
+char *frame_next(FrameReader *reader, size_t *length) {
+    char *frame = reader->buffer + reader->start;
+    const char *newline = cJSON_FindFrameEnd(frame, reader->end - reader->start);
+    if (!newline) return NULL;
+    size_t len = (size_t)(newline - frame);
+    frame[len] = '\0';
+    reader->start += len + 1;
+    if (reader->start == reader->end) reader->start = reader->end = 0;
+    if (length) *length = len;
+    return frame;
+}
+
+ssize_t frame_fill(FrameReader *reader) {
+    // Move a partial frame to the front to make room
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+    if (reader->end >= sizeof(reader->buffer) - 1) {
+        // A single frame larger than the buffer can never complete; drop it
+        fprintf(stderr, "[PROTOCOL] Frame exceeds %d bytes on socket %d, discarding\n",
+                FRAME_BUFFER_SIZE, reader->sockfd);
+        reader->end = 0;
+    }
+    ssize_t len = recv(reader->sockfd, reader->buffer + reader->end,
+                       sizeof(reader->buffer) - 1 - reader->end, 0);
+    if (len > 0) reader->end += (size_t)len;
+    return len;
+}
+
+char *recv_frame(FrameReader *reader, size_t *length) {
+    while (1) {
+        char *frame = frame_next(reader, length);
+        if (frame) return frame;
+        if (frame_fill(reader) <= 0) return NULL;
+    }
+}
+
+cJSON *recv_json(FrameReader *reader) {
+    while (1) {
+        size_t len = 0;
+        char *frame = recv_frame(reader, &len);
+        if (!frame) return NULL;
+        cJSON *msg = cJSON_ParseWithLength(frame, len);
+        if (msg) return msg;
+        fprintf(stderr, "[PROTOCOL] Dropping malformed frame on socket %d\n", reader->sockfd);
+    }
+}
+
+static const struct {
+    const char *name;
+    MessageType type;
+} message_names[] = {
+    {"HANDSHAKE", MSG_HANDSHAKE},
+    {"HANDSHAKE_ACK", MSG_HANDSHAKE_ACK},
+    {"STATUS_UPDATE", MSG_STATUS_UPDATE},
+    {"MISSION_COMPLETE", MSG_MISSION_COMPLETE},
+    {"HEARTBEAT", MSG_HEARTBEAT},
+    {"HEARTBEAT_RESPONSE", MSG_HEARTBEAT_RESPONSE},
+    {"ASSIGN_MISSION", MSG_ASSIGN_MISSION},
+    {"ERROR", MSG_ERROR},
+};
+
+MessageType message_type_from_name(const char *name, size_t length) {
+    for (size_t i = 0; i < sizeof(message_names) / sizeof(message_names[0]); i++) {
+        if (strncmp(message_names[i].name, name, length) == 0 && message_names[i].name[length] == '\0')
+            return message_names[i].type;
+    }
+    return MSG_UNKNOWN;
+}
+
+static const char *skip_spaces(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p;
+}
+
+MessageType sniff_message_type(const char *frame, size_t length) {
+    static const char key[] = "\"type\"";
+    const char *end = frame + length;
+    const char *p = skip_spaces(frame, end);
+    if (p >= end || *p != '{') return MSG_UNKNOWN;
+    p = skip_spaces(p + 1, end);
+    if ((size_t)(end - p) < sizeof(key) - 1 || memcmp(p, key, sizeof(key) - 1) != 0) return MSG_UNKNOWN;
+    p = skip_spaces(p + sizeof(key) - 1, end);
+    if (p >= end || *p != ':') return MSG_UNKNOWN;
+    p = skip_spaces(p + 1, end);
+    if (p >= end || *p != '"') return MSG_UNKNOWN;
+    const char *name = ++p;
+    // Type names never contain escapes; anything unusual goes through the full parser
+    while (p < end && *p != '"' && *p != '\\') p++;
+    if (p >= end || *p != '"') return MSG_UNKNOWN;
+    return message_type_from_name(name, (size_t)(p - name));
+}
+
+int sniff_uint_field(const char *frame, size_t length, const char *key, uint64_t *value) {
+    size_t key_len = strlen(key);
+    const char *end = frame + length;
+    const char *p = frame;
+    while ((p = memchr(p, '"', (size_t)(end - p))) != NULL) {
+        const char *after = p + 1 + key_len;
+        if (after < end && *after == '"' && memcmp(p + 1, key, key_len) == 0) {
+            const char *v = skip_spaces(after + 1, end);
+            if (v < end && *v == ':') {
+                v = skip_spaces(v + 1, end);
+                uint64_t n = 0;
+                const char *digits = v;
+                while (v < end && *v >= '0' && *v <= '9' && v - digits < 19) n = n * 10 + (uint64_t)(*v++ - '0');
+                // fractions, exponents and overlong values are left to the full parser
+                if (v == digits || (v < end && (*v == '.' || *v == 'e' || *v == 'E' || (*v >= '0' && *v <= '9')))) return 0;
+                *value = n;
+                return 1;
+            }
+        }
+        p++;
+    }
+    return 0;
+}
+
+MessageType message_type_from_json(cJSON *msg) {
+    const char *name = cJSON_GetStringValue(cJSON_GetObjectItem(msg, "type"));
+    if (!name) return MSG_UNKNOWN;
+    return message_type_from_name(name, strlen(name));
+}
@@ -13,24 +13,42 @@
 #include "headers/list.h"
 #include "headers/survivor.h"
 #include "headers/map.h"
-#include "headers/view.h"
 #include "headers/globals.h"
 #include "headers/server_config.h"
+#include "headers/protocol.h"
+#include "headers/timer.h"
+#include "headers/metrics.h"
+#include "headers/admin_http.h"
+#include "headers/lockprof.h"
+#include "headers/trace.h"
+#include "headers/log.h"
+#include "headers/flightrec.h"
+#include "headers/snapshot.h"
+#include "headers/offscreen.h"
+#include "headers/feed.h"
 #include <signal.h>
+#ifndef HEADLESS
+#include "headers/view.h"
 #include <SDL2/SDL.h>
+#endif
 #include "headers/ai.h"
 #include <limits.h>
 #include <ctype.h>
 #include <time.h>
 #include <errno.h>
+#include <sys/random.h>
+#include <sys/resource.h>
 
 #define SERVER_PORT 2100
 #define MAX_CLIENTS 64
-#define BUFFER_SIZE 2048
 
 // Protocol intervals
 #define STATUS_UPDATE_INTERVAL 5
-#define HEARTBEAT_INTERVAL 10
+#define MAX_MISSED_HEARTBEATS 3
+#define RECONNECT_GRACE 25        // seconds a dropped drone is kept for reconnect
+#define WATCHDOG_IDLE_LIMIT 60    // shut down after this long without drone traffic
+#define MISSION_EXPIRY 300
+#define SEND_TIMEOUT 2            // seconds a send to a drone may block
 
 // Global timestamp of last drone message
 time_t last_msg_time;
@@ -42,74 +60,372 @@ pthread_mutex_t survivors_mutex = PTHREAD_MUTEX_INITIALIZER;
 List *priority_survivors;
 pthread_mutex_t priority_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-// Performance tracking globals
-static double total_survivor_wait = 0;
-static int total_survivors_assigned = 0;
-static pthread_mutex_t perf_mutex = PTHREAD_MUTEX_INITIALIZER;
+// HANDSHAKE_ACK only differs per drone in its session; built once before
+// the accept loop starts
+static FrameTemplate *handshake_ack_template;
+
+// From ServerConfig; advertised to drones in HANDSHAKE_ACK
+static unsigned int heartbeat_interval_ms;
+static unsigned int heartbeat_jitter_seed;   // under drones_mutex
+
+// Fleet-wide timers; per-drone deadlines live in each Drone
+static Timer watchdog_timer;
+static FrameTemplate *heartbeat_template;
 
 // Forward declarations
 void* client_handler(void* arg);
 void* survivor_generator(void*);
 void* ai_controller(void*);
-void *heartbeat_thread(void *arg);
-void* heartbeat_monitor(void *arg);
-void* watchdog_thread(void *arg);
 void* log_performance_thread(void *arg);
 
-void send_json(int sockfd, cJSON *json) {
-    char *data = cJSON_PrintUnformatted(json);
-    size_t len = strlen(data);
-    size_t total = 0;
-    while (total < len) {
-        ssize_t sent = send(sockfd, data + total, len - total, MSG_NOSIGNAL);
-        if (sent <= 0) break;
-        total += sent;
+#ifdef LOCK_PROFILING
+// SIGUSR1: dump lock contention stats from the accept loop
+static volatile sig_atomic_t lock_report_requested;
+
+static void request_lock_report(int sig) {
+    lock_report_requested = 1;
+}
+#endif
+
+void init_handshake_ack(void) {
+    cJSON *ack = cJSON_CreateObject();
+    cJSON_AddStringToObject(ack, "type", "HANDSHAKE_ACK");
+    cJSON_AddRawToObject(ack, "session_id", FRAME_SLOT);
+    cJSON_AddRawToObject(ack, "resumed", FRAME_SLOT);
+    cJSON *cfg = cJSON_CreateObject();
+    cJSON_AddNumberToObject(cfg, "status_update_interval", STATUS_UPDATE_INTERVAL);
+    cJSON_AddNumberToObject(cfg, "heartbeat_interval", heartbeat_interval_ms / 1000);
+    cJSON_AddItemToObject(ack, "config", cfg);
+    handshake_ack_template = frame_template_create(ack);
+    cJSON_Delete(ack);
+}
+
+// Change a drone's status keeping the on-mission gauge in step.
+// Caller holds d->lock (or owns the drone exclusively).
+static void set_drone_status(Drone *d, int status) {
+    if (d->status == ON_MISSION && status != ON_MISSION) metrics_gauge_add(GAUGE_DRONES_ON_MISSION, -1);
+    else if (d->status != ON_MISSION && status == ON_MISSION) metrics_gauge_add(GAUGE_DRONES_ON_MISSION, 1);
+    d->status = status;
+}
+
+// Unlink the helped survivor at a mission target, NULL if there is none.
+// helpedsurvivors only changes under priority_mutex; caller holds it.
+static Survivor *take_helped_survivor(Coord target) {
+    for (Node *sn = helpedsurvivors->head; sn; sn = sn->next) {
+        Survivor *sv = *(Survivor **)sn->data;
+        if (sv->coord.x == target.x && sv->coord.y == target.y) {
+            helpedsurvivors->removenode(helpedsurvivors, sn);
+            return sv;
+        }
+    }
+    return NULL;
+}
+
+// Put the survivor of an in-flight mission back in the priority queue.
+// Caller holds drones_mutex.
+static void requeue_mission(Drone *d) {
+    if (d->status != ON_MISSION) return;
+    uint64_t now = monotonic_ns();
+    trace_span("travel (aborted)", d->mission_seq, d->id, d->mission_sent_ns, now);
+    mutex_lock(&priority_mutex);
+    Survivor *sv = take_helped_survivor(d->target);
+    if (sv) {
+        sv->queued_ns = now;
+        flightrec_record(FR_REQUEUE, d->id, sv->coord.x, sv->coord.y);
+        priority_survivors->add(priority_survivors, &sv);
+    }
+    mutex_unlock(&priority_mutex);
+}
+
+// Remove a drone for good. Caller holds drones_mutex. Only ever called from
+// timer callbacks, so no other timer of this drone can be running meanwhile.
+static void drop_drone(Drone *d) {
+    flightrec_record(FR_DRONE_DROPPED, d->id, 0, 0);
+    requeue_mission(d);
+    set_drone_status(d, DISCONNECTED);
+    metrics_gauge_add(GAUGE_DRONES_CONNECTED, -1);
+    metrics_inc(CTR_DRONES_DROPPED);
+    timer_cancel(&d->liveness_timer);
+    timer_cancel(&d->reconnect_timer);
+    timer_cancel(&d->mission_timer);
+    // The renderer walks the list under its own lock
+    mutex_lock(&drones->lock);
+    for (Node *n = drones->head; n; n = n->next) {
+        if (*(Drone **)n->data == d) {
+            drones->removenode(drones, n);
+            break;
+        }
+    }
+    mutex_unlock(&drones->lock);
+    pthread_mutex_destroy(&d->lock);
+    pthread_cond_destroy(&d->mission_cv);
+    free(d);
+}
+
+// Fixed per-drone offset within the interval (Fibonacci hash of the id), so
+// a fleet that connects at once is not probed at once
+static unsigned int heartbeat_phase_ms(int drone_id) {
+    uint32_t h = (uint32_t)drone_id * 2654435769u;
+    return (unsigned int)(((uint64_t)h * heartbeat_interval_ms) >> 32);
+}
+
+// Delay to the drone's next phase slot at least half an interval away, +-10%
+// jitter. Re-arming on the phase grid rather than a plain interval from now
+// keeps a fleet that reports in step (every drone's first STATUS_UPDATE
+// right after its ACK) from being probed in step. Caller holds drones_mutex.
+static unsigned int heartbeat_delay_ms(const Drone *d) {
+    unsigned int interval = heartbeat_interval_ms;
+    if (!interval) return 0;
+    unsigned int now_ms = (unsigned int)((monotonic_ns() / 1000000) % interval);
+    unsigned int wait = (heartbeat_phase_ms(d->id) + interval - now_ms) % interval;
+    if (wait < interval / 2) wait += interval;
+    unsigned int spread = interval / 5;
+    unsigned int jitter = spread ? (unsigned int)rand_r(&heartbeat_jitter_seed) % spread : 0;
+    return wait - spread / 2 + jitter;
+}
+
+// The timer thread lets go of timer_mutex before running a callback, so a
+// timer_cancel() issued while the callback waits for drones_mutex finds
+// nothing to cancel. The drone callbacks below re-check the drone's state
+// once they hold drones_mutex instead.
+
+// Drone silent for a whole interval: probe it with a HEARTBEAT, or drop it
+// once MAX_MISSED_HEARTBEATS probes went unanswered. Busy drones keep
+// pushing this timer back and never see a HEARTBEAT.
+static void liveness_expired(void *arg) {
+    Drone *d = arg;
+    mutex_lock(&drones_mutex);
+    // Stale: the socket was detached (grace period, the timer was cancelled)
+    // or traffic re-armed the timer while we waited for drones_mutex
+    if (d->sockfd < 0 || timer_pending(&d->liveness_timer)) {
+        mutex_unlock(&drones_mutex);
+        return;
+    }
+    if (d->missed_heartbeats >= MAX_MISSED_HEARTBEATS) {
+        log_warn(LOG_MOD_SERVER, "[SERVER] Drone %d missed %d heartbeats, disconnecting\n", d->id, MAX_MISSED_HEARTBEATS);
+        drop_drone(d);
+        mutex_unlock(&drones_mutex);
+        return;
+    }
+    char ts[12], sent_ns[24];
+    snprintf(ts, sizeof(ts), "%d", (int)time(NULL));
+    // Echoed back in HEARTBEAT_RESPONSE to measure the round trip
+    snprintf(sent_ns, sizeof(sent_ns), "%llu", (unsigned long long)monotonic_ns());
+    const char *fields[] = { ts, sent_ns };
+    PrintBuffer *out = thread_print_buffer();
+    size_t len = frame_template_render(heartbeat_template, out, fields);
+    int sock = d->sockfd;
+    d->missed_heartbeats++;
+    flightrec_record(FR_HEARTBEAT_SENT, d->id, d->missed_heartbeats, 0);
+    timer_schedule(&d->liveness_timer, heartbeat_delay_ms(d));
+    mutex_unlock(&drones_mutex);
+    // Every drone's timers share this thread: never wait on a drone that
+    // stopped reading. A full send buffer is one more missed heartbeat; a
+    // partial frame would garble the stream, so that ends the connection.
+    if (!len) return;
+    ssize_t sent = send(sock, out->data, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (sent == (ssize_t)len) metrics_inc(CTR_TX_HEARTBEAT);
+    else if (sent > 0) shutdown(sock, SHUT_RDWR);
+}
+
+// Any valid frame from a drone proves it alive. Caller holds drones_mutex.
+static void mark_drone_alive(Drone *d) {
+    d->last_seen = time(NULL);
+    d->missed_heartbeats = 0;
+    timer_schedule(&d->liveness_timer, heartbeat_delay_ms(d));
+}
+
+static void drone_traffic(int client_sock) {
+    mutex_lock(&drones_mutex);
+    for (Node* n = drones->head; n; n = n->next) {
+        Drone* d = *(Drone**)n->data;
+        if (d->sockfd == client_sock) {
+            mark_drone_alive(d);
+            break;
+        }
+    }
+    mutex_unlock(&drones_mutex);
+}
+
+static void reconnect_expired(void *arg) {
+    Drone *d = arg;
+    mutex_lock(&drones_mutex);
+    // Stale: the drone resumed on a new socket, or resumed and dropped again
+    // and has a fresh grace period running
+    if (d->sockfd >= 0 || timer_pending(&d->reconnect_timer)) {
+        mutex_unlock(&drones_mutex);
+        return;
+    }
+    log_warn(LOG_MOD_SERVER, "[SERVER] Drone %d failed to reconnect, disconnecting\n", d->id);
+    drop_drone(d);
+    mutex_unlock(&drones_mutex);
+}
+
+// ASSIGN_MISSION expiry passed without MISSION_COMPLETE
+static void mission_expired(void *arg) {
+    Drone *d = arg;
+    mutex_lock(&drones_mutex);
+    mutex_lock(&d->lock);
+    // A pending timer means a newer mission was assigned meanwhile
+    if (d->status == ON_MISSION && !timer_pending(&d->mission_timer)) {
+        log_warn(LOG_MOD_SERVER, "[SERVER] Mission of drone %d to (%d,%d) expired, requeueing survivor\n",
+                 d->id, d->target.x, d->target.y);
+        flightrec_record(FR_MISSION_EXPIRED, d->id, d->target.x, d->target.y);
+        requeue_mission(d);
+        set_drone_status(d, (d->sockfd >= 0) ? IDLE : DISCONNECTED);
+        metrics_inc(CTR_MISSIONS_EXPIRED);
+    }
+    mutex_unlock(&d->lock);
+    mutex_unlock(&drones_mutex);
+}
+
+// Watchdog: shutdown if no drone messages in WATCHDOG_IDLE_LIMIT seconds
+static void watchdog_expired(void *arg) {
+    time_t idle = time(NULL) - last_msg_time;
+    if (idle >= WATCHDOG_IDLE_LIMIT) {
+        log_info(LOG_MOD_SERVER, "[SERVER] No drone activity for %ds, shutting down\n", WATCHDOG_IDLE_LIMIT);
+        flightrec_record(FR_WATCHDOG, (int)idle, 0, 0);
+        flightrec_dump("watchdog shutdown");
+        // terminate immediately to avoid threads accessing freed data
+        exit(EXIT_SUCCESS);
+    }
+    // Traffic arrived meanwhile: sleep until the new deadline
+    timer_schedule(&watchdog_timer, (unsigned int)(WATCHDOG_IDLE_LIMIT - idle) * 1000);
+}
+
+static void start_liveness_timers(void) {
+    // HEARTBEAT only differs in its timestamp
+    cJSON *hb = cJSON_CreateObject();
+    cJSON_AddStringToObject(hb, "type", "HEARTBEAT");
+    cJSON_AddRawToObject(hb, "timestamp", FRAME_SLOT);
+    cJSON_AddRawToObject(hb, "sent_ns", FRAME_SLOT);
+    heartbeat_template = frame_template_create(hb);
+    cJSON_Delete(hb);
+    timer_init(&watchdog_timer, watchdog_expired, NULL);
+    timer_schedule(&watchdog_timer, WATCHDOG_IDLE_LIMIT * 1000);
+}
+
+// Socket dropped: keep the drone (and its mission) for the reconnect grace period
+static void detach_drone_socket(int client_sock) {
+    mutex_lock(&drones_mutex);
+    for (Node* n = drones->head; n; n = n->next) {
+        Drone* d = *(Drone**)n->data;
+        if (d->sockfd == client_sock) {
+            mutex_lock(&d->lock);
+            d->sockfd = -1;
+            if (d->status == IDLE) set_drone_status(d, DISCONNECTED);
+            mutex_unlock(&d->lock);
+            timer_cancel(&d->liveness_timer);
+            timer_schedule(&d->reconnect_timer, RECONNECT_GRACE * 1000);
+            break;
+        }
+    }
+    mutex_unlock(&drones_mutex);
+}
+
+// Random token a reconnecting drone presents to get its record back
+static void new_session_id(char *out) {
+    uint64_t r;
+    if (getrandom(&r, sizeof(r), 0) != (ssize_t)sizeof(r)) r = monotonic_ns() * 0x9e3779b97f4a7c15ull;
+    snprintf(out, SESSION_ID_LEN + 1, "%016llx", (unsigned long long)r);
+}
+
+// Registered drone with this id and session, or NULL. Caller holds drones_mutex.
+static Drone *find_session(int id, const char *session_id) {
+    for (Node *n = drones->head; n; n = n->next) {
+        Drone *d = *(Drone **)n->data;
+        if (d->id == id && strcmp(d->session_id, session_id) == 0) return d;
     }
-    // Send newline delimiter
-    send(sockfd, "\n", 1, MSG_NOSIGNAL);
-    free(data);
+    return NULL;
 }
 
-cJSON* recv_json(int sockfd, char *buffer, size_t buflen) {
-    ssize_t len = recv(sockfd, buffer, buflen - 1, 0);
-    if (len <= 0) return NULL;
-    buffer[len] = '\0';
-    return cJSON_Parse(buffer);
+// Move a drone record, with its mission in flight, onto a new connection.
+// Caller holds drones_mutex.
+static void resume_drone(Drone *d, int client_sock) {
+    int old_sock = d->sockfd;
+    mutex_lock(&d->lock);
+    d->sockfd = client_sock;
+    if (d->status == DISCONNECTED) set_drone_status(d, IDLE);
+    mutex_unlock(&d->lock);
+    timer_cancel(&d->reconnect_timer);
+    // The old connection may not have noticed the drop yet: end it, its
+    // handler then finds no drone left on that socket
+    if (old_sock >= 0) shutdown(old_sock, SHUT_RDWR);
+    mark_drone_alive(d);
+    metrics_inc(CTR_SESSIONS_RESUMED);
+    flightrec_record(FR_RESUME, d->id, client_sock, old_sock);
+    log_info(LOG_MOD_SERVER, "[SERVER] Drone %d resumed its session on socket %d\n", d->id, client_sock);
 }
 
-void handle_handshake(int client_sock, cJSON *msg) {
-    printf("[SERVER] HANDSHAKE received from drone_id: %s\n", cJSON_GetObjectItem(msg, "drone_id")->valuestring);
+static void send_error(int client_sock, int code, const char *message) {
+    cJSON *err = cJSON_CreateObject();
+    cJSON_AddStringToObject(err, "type", "ERROR");
+    cJSON_AddNumberToObject(err, "code", code);
+    cJSON_AddStringToObject(err, "message", message);
+    cJSON_AddNumberToObject(err, "timestamp", (int)time(NULL));
+    send_json(client_sock, err);
+    cJSON_Delete(err);
+}
+
+// Register or resume the drone and send HANDSHAKE_ACK. -1 if the fleet is
+// full: the drone got an ERROR and the caller closes the connection.
+int handle_handshake(int client_sock, cJSON *msg) {
+    log_info(LOG_MOD_SERVER, "[SERVER] HANDSHAKE received from drone_id: %s\n", cJSON_GetObjectItem(msg, "drone_id")->valuestring);
     // Register drone, add to drone list
     const char *idstr = cJSON_GetObjectItem(msg, "drone_id")->valuestring;
     int id = 0;
     if ((idstr[0] == 'd' || idstr[0] == 'D') && idstr[1]) id = atoi(idstr + 1);
     else id = atoi(idstr);
-    Drone *d = malloc(sizeof(Drone));
-    memset(d,0,sizeof(Drone));
-    d->id = id; d->sockfd = client_sock; d->status = IDLE;
-    d->coord = (Coord){0,0}; d->target = d->coord;
-    pthread_mutex_init(&d->lock,NULL); d->lock_initialized=true;
-    pthread_cond_init(&d->mission_cv,NULL); d->cv_initialized=true;
-    pthread_mutex_lock(&drones_mutex);
-    drones->add(drones,&d);
-    pthread_mutex_unlock(&drones_mutex);
-    // Send HANDSHAKE_ACK with session_id and config
-    cJSON *ack = cJSON_CreateObject();
-    cJSON_AddStringToObject(ack, "type", "HANDSHAKE_ACK");
-    cJSON_AddStringToObject(ack, "session_id", "S1");
-    cJSON *cfg = cJSON_CreateObject();
-    cJSON_AddNumberToObject(cfg, "status_update_interval", STATUS_UPDATE_INTERVAL);
-    cJSON_AddNumberToObject(cfg, "heartbeat_interval", HEARTBEAT_INTERVAL);
-    cJSON_AddItemToObject(ack, "config", cfg);
-    send_json(client_sock, ack);
-    cJSON_Delete(ack);
+    flightrec_record(FR_HANDSHAKE, id, client_sock, 0);
+    char session_id[SESSION_ID_LEN + 1];
+    int resumed = 0;
+    cJSON *session = cJSON_GetObjectItem(msg, "session_id");
+    mutex_lock(&drones_mutex);
+    Drone *d = cJSON_IsString(session) ? find_session(id, session->valuestring) : NULL;
+    if (d) {
+        resume_drone(d, client_sock);
+        resumed = 1;
+    } else if (drones->number_of_elements >= drones->capacity) {
+        // drones->add would block under drones_mutex until a drone leaves,
+        // wedging the AI and every timer callback meanwhile
+        mutex_unlock(&drones_mutex);
+        metrics_inc(CTR_HANDSHAKES_REJECTED);
+        flightrec_record(FR_REJECTED, id, client_sock, 0);
+        log_warn(LOG_MOD_SERVER, "[SERVER] Rejecting drone %d: %d drones registered (max_drones)\n", id, drones->capacity);
+        send_error(client_sock, 503, "Server full: max_drones reached");
+        return -1;
+    } else {
+        d = malloc(sizeof(Drone));
+        memset(d,0,sizeof(Drone));
+        d->id = id; d->sockfd = client_sock; d->status = IDLE;
+        d->coord = (Coord){0,0}; d->target = d->coord;
+        new_session_id(d->session_id);
+        pthread_mutex_init(&d->lock,NULL); d->lock_initialized=true;
+        pthread_cond_init(&d->mission_cv,NULL); d->cv_initialized=true;
+        timer_init(&d->liveness_timer, liveness_expired, d);
+        timer_init(&d->reconnect_timer, reconnect_expired, d);
+        timer_init(&d->mission_timer, mission_expired, d);
+        drones->add(drones,&d);
+        metrics_gauge_add(GAUGE_DRONES_CONNECTED, 1);
+        mark_drone_alive(d);
+    }
+    memcpy(session_id, d->session_id, sizeof(session_id));
+    mutex_unlock(&drones_mutex);
+    // HANDSHAKE_ACK with the session and config
+    char session_json[SESSION_ID_LEN + 3];
+    snprintf(session_json, sizeof(session_json), "\"%s\"", session_id);
+    const char *fields[] = { session_json, resumed ? "true" : "false" };
+    PrintBuffer *out = thread_print_buffer();
+    size_t len = frame_template_render(handshake_ack_template, out, fields);
+    if (len) send_all(client_sock, out->data, len);
+    return 0;
 }
 
 void handle_status_update(int client_sock, cJSON *msg) {
     int timestamp = cJSON_GetObjectItem(msg, "timestamp")->valueint;
     int battery = cJSON_GetObjectItem(msg, "battery")->valueint;
     int speed = cJSON_GetObjectItem(msg, "speed")->valueint;
-    printf("[SERVER] STATUS_UPDATE from drone_id: %s, status: %s, timestamp: %d, battery: %d, speed: %d\n",
+    log_debug(LOG_MOD_SERVER, "[SERVER] STATUS_UPDATE from drone_id: %s, status: %s, timestamp: %d, battery: %d, speed: %d\n",
         cJSON_GetObjectItem(msg, "drone_id")->valuestring,
         cJSON_GetObjectItem(msg, "status")->valuestring,
         timestamp, battery, speed);
@@ -122,32 +438,35 @@ void handle_status_update(int client_sock, cJSON *msg) {
     int x = cJSON_GetObjectItem(loc, "x")->valueint;
     int y = cJSON_GetObjectItem(loc, "y")->valueint;
     const char *st = cJSON_GetObjectItem(msg, "status")->valuestring;
-    pthread_mutex_lock(&drones_mutex);
+    flightrec_record(FR_STATUS_UPDATE, id, x, y);
+    mutex_lock(&drones_mutex);
     for (Node *n = drones->head; n; n = n->next) {
         Drone *d = *(Drone **)n->data;
         if (d->id == id) {
-            pthread_mutex_lock(&d->lock);
+            mutex_lock(&d->lock);
+            // Cells per update shows how far drones coalesce their reports
+            metrics_add(CTR_STATUS_CELLS, (uint64_t)(abs(x - d->coord.x) + abs(y - d->coord.y)));
             d->coord.x = x;
             d->coord.y = y;
             if (strcmp(st, "idle") == 0) {
                 if (d->status != ON_MISSION) {
-                    d->status = IDLE;
+                    set_drone_status(d, IDLE);
                 }
             } else if (strcmp(st, "busy") == 0) {
-                d->status = ON_MISSION;
+                set_drone_status(d, ON_MISSION);
             }
-            pthread_mutex_unlock(&d->lock);
+            mutex_unlock(&d->lock);
             break;
         }
     }
-    pthread_mutex_unlock(&drones_mutex);
+    mutex_unlock(&drones_mutex);
 }
 
 void handle_mission_complete(int client_sock, cJSON *msg) {
     int timestamp = cJSON_GetObjectItem(msg, "timestamp")->valueint;
     int success = cJSON_GetObjectItem(msg, "success")->valueint;
     const char *details = cJSON_GetObjectItem(msg, "details")->valuestring;
-    printf("[SERVER] MISSION_COMPLETE from drone_id: %s, mission_id: %s, timestamp: %d, success: %s, details: %s\n",
+    log_info(LOG_MOD_SERVER, "[SERVER] MISSION_COMPLETE from drone_id: %s, mission_id: %s, timestamp: %d, success: %s, details: %s\n",
         cJSON_GetObjectItem(msg, "drone_id")->valuestring,
         cJSON_GetObjectItem(msg, "mission_id")->valuestring,
         timestamp,
@@ -158,30 +477,54 @@ void handle_mission_complete(int client_sock, cJSON *msg) {
     int id = 0;
     if ((idstr[0] == 'd' || idstr[0] == 'D') && idstr[1]) id = atoi(idstr + 1);
     else id = atoi(idstr);
-    pthread_mutex_lock(&drones_mutex);
+    flightrec_record(FR_MISSION_COMPLETE, id, success, 0);
+    mutex_lock(&drones_mutex);
     for (Node *n = drones->head; n; n = n->next) {
         Drone *d = *(Drone **)n->data;
         if (d->id == id) {
-            pthread_mutex_lock(&d->lock);
-            d->status = IDLE;
-            pthread_mutex_unlock(&d->lock);
+            mutex_lock(&d->lock);
+            if (d->status == ON_MISSION) {
+                trace_span("travel", d->mission_seq, d->id, d->mission_sent_ns, monotonic_ns());
+                // Helped for good: keeps helpedsurvivors at one entry per mission in flight
+                mutex_lock(&priority_mutex);
+                take_helped_survivor(d->target);
+                mutex_unlock(&priority_mutex);
+            }
+            set_drone_status(d, IDLE);
+            mutex_unlock(&d->lock);
+            timer_cancel(&d->mission_timer);
+            metrics_inc(CTR_MISSIONS_COMPLETED);
             break;
         }
     }
-    pthread_mutex_unlock(&drones_mutex);
+    mutex_unlock(&drones_mutex);
 }
 
-void handle_heartbeat_response(int client_sock, cJSON *msg) {
-    pthread_mutex_lock(&drones_mutex);
+void handle_heartbeat_response(int client_sock, uint64_t then) {
+    uint64_t now = monotonic_ns();
+    if (then == 0 || then > now) return;
+    uint64_t rtt = now - then;
+    flightrec_record(FR_HEARTBEAT_RTT, client_sock, (int)(rtt / 1000), 0);
+    mutex_lock(&drones_mutex);
     for (Node* n = drones->head; n; n = n->next) {
         Drone* d = *(Drone**)n->data;
         if (d->sockfd == client_sock) {
-            d->last_heartbeat = time(NULL);
-            d->missed_heartbeats = 0;
+            histogram_record(&d->rtt, rtt);
             break;
         }
     }
-    pthread_mutex_unlock(&drones_mutex);
+    mutex_unlock(&drones_mutex);
+    metrics_observe(HIST_HEARTBEAT_RTT, rtt);
+}
+
+static CounterId rx_counter(MessageType type) {
+    switch (type) {
+        case MSG_HANDSHAKE: return CTR_RX_HANDSHAKE;
+        case MSG_STATUS_UPDATE: return CTR_RX_STATUS_UPDATE;
+        case MSG_MISSION_COMPLETE: return CTR_RX_MISSION_COMPLETE;
+        case MSG_HEARTBEAT_RESPONSE: return CTR_RX_HEARTBEAT_RESPONSE;
+        default: return CTR_RX_UNKNOWN;
+    }
 }
 
 void* client_handler(void* arg) {
@@ -189,71 +532,77 @@ void* client_handler(void* arg) {
     free(arg);
     struct timeval tv = {1, 0};
     setsockopt(client_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-    time_t disconnect_start = 0;
-    bool waiting_reconnect = false;
+    // Sends to a drone that stopped reading give up instead of hanging the sender
+    tv.tv_sec = SEND_TIMEOUT;
+    setsockopt(client_sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
     char drone_id_str[32] = "";
-    printf("[SERVER] New client connected, socket: %d\n", client_sock);
-    char buffer[BUFFER_SIZE];
+    log_info(LOG_MOD_SERVER, "[SERVER] New client connected, socket: %d\n", client_sock);
+    flightrec_record(FR_CONNECT, client_sock, 0, 0);
+    FrameReader reader;
+    frame_reader_init(&reader, client_sock);
     while (running) {
         // receive JSON message
         errno = 0;
-        cJSON *msg = recv_json(client_sock, buffer, sizeof(buffer));
-        if (msg) last_msg_time = time(NULL);
-        if (!msg) {
+        size_t frame_len = 0;
+        char *frame = recv_frame(&reader, &frame_len);
+        if (frame) last_msg_time = time(NULL);
+        if (!frame) {
             if (errno == EAGAIN || errno == EWOULDBLOCK) continue;
-            if (!waiting_reconnect) {
-                disconnect_start = time(NULL);
-                waiting_reconnect = true;
-                printf("[SERVER] Drone %s disconnected, waiting 25s for reconnect\n", drone_id_str);
-            } else if (time(NULL) - disconnect_start >= 25) {
-                printf("[SERVER] Drone %s failed to reconnect, disconnecting\n", drone_id_str);
-                pthread_mutex_lock(&drones_mutex);
-                for (Node* n = drones->head; n; n = n->next) {
-                    Drone* d = *(Drone**)n->data;
-                    if (d->sockfd == client_sock) {
-                        d->status = DISCONNECTED;
-                        drones->removenode(drones, n);
-                        free(d);
-                        break;
-                    }
-                }
-                pthread_mutex_unlock(&drones_mutex);
-                break;
+            // The timer service drops the drone if it does not come back in time
+            log_warn(LOG_MOD_SERVER, "[SERVER] Drone %s disconnected, waiting %ds for reconnect\n", drone_id_str, RECONNECT_GRACE);
+            flightrec_record(FR_DISCONNECT, client_sock, 0, 0);
+            detach_drone_socket(client_sock);
+            break;
+        }
+        MessageType type = sniff_message_type(frame, frame_len);
+        cJSON *msg = NULL;
+        // HEARTBEAT_RESPONSE only carries sent_ns, read straight from the raw frame
+        if (type != MSG_HEARTBEAT_RESPONSE) {
+            uint64_t parse_start = monotonic_ns();
+            msg = cJSON_ParseWithLength(frame, frame_len);
+            metrics_observe(HIST_PARSE_TIME, monotonic_ns() - parse_start);
+            if (!msg) {
+                metrics_inc(CTR_RX_MALFORMED);
+                flightrec_record(FR_MALFORMED, client_sock, (int)frame_len, 0);
+                log_warn(LOG_MOD_SERVER, "[SERVER] Dropping malformed frame from drone %s\n", drone_id_str);
+                continue;
             }
-            continue;
+            if (type == MSG_UNKNOWN) type = message_type_from_json(msg);
         }
-        if (waiting_reconnect) waiting_reconnect = false;
-        const char* type = cJSON_GetObjectItem(msg, "type")->valuestring;
-        if (strcmp(type, "HANDSHAKE") == 0) {
+        metrics_inc(rx_counter(type));
+        metrics_add(CTR_RX_BYTES, frame_len + 1);
+        flightrec_record(FR_RX, client_sock, type, (int)frame_len);
+        // Any valid frame counts as a heartbeat (handshake arms its own timer)
+        if (type != MSG_UNKNOWN && type != MSG_HANDSHAKE) drone_traffic(client_sock);
+        if (type == MSG_HANDSHAKE) {
             const char* idstr = cJSON_GetObjectItem(msg, "drone_id")->valuestring;
             strncpy(drone_id_str, idstr, sizeof(drone_id_str)-1);
             drone_id_str[sizeof(drone_id_str)-1] = '\0';
-            handle_handshake(client_sock, msg);
-        } else if (strcmp(type, "STATUS_UPDATE") == 0) {
+            if (handle_handshake(client_sock, msg) < 0) {
+                cJSON_Delete(msg);
+                break;
+            }
+        } else if (type == MSG_STATUS_UPDATE) {
             handle_status_update(client_sock, msg);
-        } else if (strcmp(type, "MISSION_COMPLETE") == 0) {
+        } else if (type == MSG_MISSION_COMPLETE) {
             // Handle mission completions from drone
             handle_mission_complete(client_sock, msg);
-        } else if (strcmp(type, "HEARTBEAT_RESPONSE") == 0) {
-            // Update heartbeat timestamp
-            handle_heartbeat_response(client_sock, msg);
+        } else if (type == MSG_HEARTBEAT_RESPONSE) {
+            // Record the heartbeat round trip (drones that do not echo sent_ns are skipped)
+            uint64_t sent_ns;
+            if (sniff_uint_field(frame, frame_len, "sent_ns", &sent_ns)) handle_heartbeat_response(client_sock, sent_ns);
         } else {
             // Send ERROR for unknown message type
-            cJSON *err = cJSON_CreateObject();
-            cJSON_AddStringToObject(err, "type", "ERROR");
-            cJSON_AddNumberToObject(err, "code", 400);
-            cJSON_AddStringToObject(err, "message", "Unknown message type");
-            cJSON_AddNumberToObject(err, "timestamp", (int)time(NULL));
-            send_json(client_sock, err);
-            cJSON_Delete(err);
+            send_error(client_sock, 400, "Unknown message type");
         }
         cJSON_Delete(msg);
     }
-    printf("[SERVER] Client handler exiting, socket: %d\n", client_sock);
+    log_debug(LOG_MOD_SERVER, "[SERVER] Client handler exiting, socket: %d\n", client_sock);
     close(client_sock);
     pthread_exit(NULL);
 }
 
+#ifndef HEADLESS
 // UI thread to handle SDL rendering
 void *ui_thread(void *arg) {
     // Initialize SDL window and renderer in UI thread
@@ -267,29 +616,63 @@ void *ui_thread(void *arg) {
     quit_all();
     return NULL;
 }
+#endif
 
 // Log performance periodically
+static void print_latency(const char *label, const Histogram *h, double scale, const char *unit) {
+    if (!h->count) return;
+    printf("[PERF] %s: p50 %.3f %s, p95 %.3f %s, p99 %.3f %s, max %.3f %s (%llu samples)\n",
+           label,
+           histogram_percentile(h, 0.50) / scale, unit, histogram_percentile(h, 0.95) / scale, unit,
+           histogram_percentile(h, 0.99) / scale, unit, h->max / scale, unit,
+           (unsigned long long)h->count);
+}
+
 void* log_performance_thread(void* arg) {
+    MetricsSnapshot *m = malloc(sizeof(MetricsSnapshot));
+    if (!m) return NULL;
     while (running) {
         sleep(30);
-        // Average wait
-        pthread_mutex_lock(&perf_mutex);
-        double avg_wait = total_survivors_assigned ? total_survivor_wait / total_survivors_assigned : 0;
-        int count = total_survivors_assigned;
-        pthread_mutex_unlock(&perf_mutex);
+        metrics_snapshot(m);
+        const Histogram *wait = &m->histograms[HIST_SURVIVOR_WAIT];
+        double avg_wait = wait->count ? (double)wait->sum / wait->count / 1e9 : 0;
         // Drone utilization
-        int total=0, busy=0;
-        pthread_mutex_lock(&drones_mutex);
+        int64_t total = m->gauges[GAUGE_DRONES_CONNECTED];
+        int64_t busy = m->gauges[GAUGE_DRONES_ON_MISSION];
+        double util = total ? (double)busy/total * 100.0 : 0;
+        printf("[PERF] Avg survivor wait: %.1f s over %llu; Drone util: %.1f%% (%lld/%lld)\n",
+               avg_wait, (unsigned long long)wait->count, util, (long long)busy, (long long)total);
+        printf("[PERF] Queues: %lld new, %lld priority survivors waiting\n",
+               (long long)m->gauges[GAUGE_SURVIVORS_WAITING], (long long)m->gauges[GAUGE_SURVIVORS_PRIORITY]);
+        printf("[PERF] Received: %llu HANDSHAKE, %llu STATUS_UPDATE, %llu MISSION_COMPLETE, %llu HEARTBEAT_RESPONSE, %llu unknown, %llu malformed\n",
+               (unsigned long long)m->counters[CTR_RX_HANDSHAKE], (unsigned long long)m->counters[CTR_RX_STATUS_UPDATE],
+               (unsigned long long)m->counters[CTR_RX_MISSION_COMPLETE], (unsigned long long)m->counters[CTR_RX_HEARTBEAT_RESPONSE],
+               (unsigned long long)m->counters[CTR_RX_UNKNOWN], (unsigned long long)m->counters[CTR_RX_MALFORMED]);
+        uint64_t updates = m->counters[CTR_RX_STATUS_UPDATE];
+        printf("[PERF] Inbound: %llu bytes; %.1f cells moved per STATUS_UPDATE\n",
+               (unsigned long long)m->counters[CTR_RX_BYTES],
+               updates ? (double)m->counters[CTR_STATUS_CELLS] / updates : 0.0);
+        printf("[PERF] Sent: %llu ASSIGN_MISSION, %llu HEARTBEAT; missions %llu completed, %llu expired; %llu drones dropped, %llu sessions resumed\n",
+               (unsigned long long)m->counters[CTR_TX_ASSIGN_MISSION], (unsigned long long)m->counters[CTR_TX_HEARTBEAT],
+               (unsigned long long)m->counters[CTR_MISSIONS_COMPLETED], (unsigned long long)m->counters[CTR_MISSIONS_EXPIRED],
+               (unsigned long long)m->counters[CTR_DRONES_DROPPED], (unsigned long long)m->counters[CTR_SESSIONS_RESUMED]);
+        print_latency("Survivor wait", wait, 1e9, "s");
+        print_latency("Assignment latency", &m->histograms[HIST_ASSIGNMENT_LATENCY], 1e3, "us");
+        print_latency("Parse time", &m->histograms[HIST_PARSE_TIME], 1e3, "us");
+        print_latency("Frame time", &m->histograms[HIST_FRAME_TIME], 1e3, "us");
+        // Heartbeat round trips: network plus both sides' queueing
+        print_latency("Heartbeat RTT fleet", &m->histograms[HIST_HEARTBEAT_RTT], 1e6, "ms");
+        mutex_lock(&drones_mutex);
         for (Node* n = drones->head; n; n = n->next) {
-            total++;
             Drone* d = *(Drone**)n->data;
-            if (d->status == ON_MISSION) busy++;
+            if (!d->rtt.count) continue;
+            char label[32];
+            snprintf(label, sizeof(label), "Heartbeat RTT drone %d", d->id);
+            print_latency(label, &d->rtt, 1e6, "ms");
         }
-        pthread_mutex_unlock(&drones_mutex);
-        double util = total ? (double)busy/total * 100.0 : 0;
-        printf("[PERF] Avg survivor wait: %.1f s over %d; Drone util: %.1f%% (%d/%d)\n",
-               avg_wait, count, util, busy, total);
+        mutex_unlock(&drones_mutex);
     }
+    free(m);
     return NULL;
 }
 
@@ -298,6 +681,18 @@ int main(int argc, char *argv[]) {
     // Display welcome banner and get configuration
     print_server_banner();
     ServerConfig config = get_server_config();
+    // --headless: run without the renderer thread (HEADLESS builds never have one)
+#ifdef HEADLESS
+    int headless = 1;
+#else
+    int headless = 0;
+#endif
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0) {
+        headless = 1;
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+    }
     // Override map dimensions from command-line if provided
     if (argc == 3) {
         int w = atoi(argv[1]);
@@ -309,10 +704,22 @@ int main(int argc, char *argv[]) {
             fprintf(stderr, "Invalid map size. Using defaults.\n");
         }
     } else if (argc != 1) {
-        fprintf(stderr, "Usage: %s [map_width map_height]\n", argv[0]);
+        fprintf(stderr, "Usage: %s [--headless] [map_width map_height]\n", argv[0]);
+        fprintf(stderr, "Environment: HEARTBEAT_INTERVAL=<seconds> MAX_DRONES=<n> FRAME_INTERVAL=<seconds>\n");
         exit(EXIT_FAILURE);
     }
     apply_server_config(config);
+    log_init();
+    // One descriptor per drone plus listeners, admin connections and logs
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < (rlim_t)config.max_drones + 64) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+        if (lim.rlim_cur < (rlim_t)config.max_drones + 64)
+            fprintf(stderr, "[SERVER] Open file limit %llu is below %d drones\n", (unsigned long long)lim.rlim_cur, config.max_drones);
+    }
+    heartbeat_interval_ms = (unsigned int)config.heartbeat_interval * 1000;
+    heartbeat_jitter_seed = (unsigned int)time(NULL);
 
     int server_sock, *client_sock;
     struct sockaddr_in server_addr, client_addr;
@@ -323,17 +730,34 @@ int main(int argc, char *argv[]) {
     drones = create_list(sizeof(Drone*), config.max_drones);
     // Store pointers to Survivor
     survivors = create_list(sizeof(Survivor*), 128);
-    // Store pointers to Survivor for helped list
-    helpedsurvivors = create_list(sizeof(Survivor*), 128);
+    // Store pointers to Survivor for helped list: one per mission in flight,
+    // so it never fills and the AI's add never waits
+    helpedsurvivors = create_list(sizeof(Survivor*), config.max_drones);
+    init_handshake_ack();
     // initialize priority queue (same capacity as survivors list)
     priority_survivors = create_list(sizeof(Survivor*), 128);
     pthread_mutex_init(&priority_mutex, NULL);
+    // Locks reported by the contention profiler (LOCK_PROFILING builds)
+    lockprof_name(&drones_mutex, "drones_mutex");
+    lockprof_name(&survivors_mutex, "survivors_mutex");
+    lockprof_name(&priority_mutex, "priority_mutex");
+    lockprof_name(&drones->lock, "drones.lock");
+    lockprof_name(&survivors->lock, "survivors.lock");
+    lockprof_name(&helpedsurvivors->lock, "helpedsurvivors.lock");
+    lockprof_name(&priority_survivors->lock, "priority_survivors.lock");
+#ifdef LOCK_PROFILING
+    signal(SIGUSR1, request_lock_report);
+#endif
+    // Recent events are dumped here on a crash, SIGUSR2 or watchdog shutdown
+    char flightrec_path[64];
+    snprintf(flightrec_path, sizeof(flightrec_path), "flightrec-%d.log", (int)getpid());
+    if (flightrec_install(flightrec_path) < 0) perror("flight recorder");
     
     // Initialize map dimensions with configured values (height, width)
     init_map(config.map_height, config.map_width);
     
     // Start Phase1 simulator threads
-    pthread_t surv_tid, ai_tid, ui_tid, perf_tid;
+    pthread_t surv_tid, ai_tid, perf_tid;
     
     // Start survivor generator with configured spawn rate
     struct timespec spawn_interval = {.tv_sec = config.survivor_spawn_rate, .tv_nsec = 0};
@@ -343,26 +767,34 @@ int main(int argc, char *argv[]) {
     pthread_create(&ai_tid, NULL, ai_controller, NULL);
     pthread_detach(ai_tid);
 
-    // Start UI thread for SDL rendering
-    pthread_create(&ui_tid, NULL, ui_thread, NULL);
-    pthread_detach(ui_tid);
-
-    pthread_t hb_mon_tid;
-    pthread_create(&hb_mon_tid, NULL, heartbeat_monitor, NULL);
-    pthread_detach(hb_mon_tid);
-
-    pthread_t hb_send_tid;
-    pthread_create(&hb_send_tid, NULL, heartbeat_thread, NULL);
-    pthread_detach(hb_send_tid);
+    if (headless) {
+        printf("[SERVER] Running headless, no renderer\n");
+    }
+#ifndef HEADLESS
+    else {
+        // Start UI thread for SDL rendering
+        pthread_t ui_tid;
+        pthread_create(&ui_tid, NULL, ui_thread, NULL);
+        pthread_detach(ui_tid);
+    }
+#endif
 
     pthread_create(&perf_tid, NULL, log_performance_thread, NULL);
     pthread_detach(perf_tid);
 
     // initialize last drone activity timestamp
     last_msg_time = time(NULL);
-    pthread_t wd_tid;
-    pthread_create(&wd_tid, NULL, watchdog_thread, NULL);
-    pthread_detach(wd_tid);
+    // Heartbeats, liveness, reconnect grace, mission expiry and the watchdog
+    // all run off the timer service
+    timer_service_start();
+    start_liveness_timers();
+    // The renderer draws from copies of the world published off the timer service
+    if (!headless) snapshot_start();
+    // Timelapse PNGs, rendered in software so headless runs get them too
+    if (config.frame_interval > 0) {
+        offscreen_start(config.frame_interval);
+        printf("[SERVER] Writing a frame to %s/ every %d seconds\n", OFFSCREEN_DIR, config.frame_interval);
+    }
 
     server_sock = socket(AF_INET, SOCK_STREAM, 0);
     if (server_sock < 0) { perror("socket"); exit(EXIT_FAILURE); }
@@ -381,18 +813,35 @@ int main(int argc, char *argv[]) {
     
     printf("[SERVER] Listening on port %d...\n", config.port);
 
-    fd_set readfds;
-    struct timeval tv;
+    if (config.admin_port) {
+        if (admin_http_start(config.admin_port) == 0)
+            printf("[SERVER] Metrics at http://127.0.0.1:%d/metrics\n", config.admin_port);
+        else
+            perror("[SERVER] admin port");
+    }
+    if (config.feed_port) {
+        if (feed_start(config.feed_port) == 0)
+            printf("[SERVER] State feed on 127.0.0.1:%d\n", config.feed_port);
+        else
+            perror("[SERVER] feed port");
+    }
+
+    struct pollfd fds[1 + ADMIN_POLL_FDS];
     while (running) {
         // Await incoming connections or other network events
-        FD_ZERO(&readfds);
-        FD_SET(server_sock, &readfds);
-        tv.tv_sec = 1; // timeout 1s
-        tv.tv_usec = 0;
-
-        int activity = select(server_sock + 1, &readfds, NULL, NULL, &tv);
+        fds[0] = (struct pollfd){ .fd = server_sock, .events = POLLIN };
+        int count = 1 + admin_http_fill_fds(fds + 1);
+
+        int activity = poll(fds, (nfds_t)count, 1000); // timeout 1s
+        if (activity > 0) admin_http_service(fds + 1, count - 1);
+#ifdef LOCK_PROFILING
+        if (lock_report_requested) {
+            lock_report_requested = 0;
+            lockprof_report(stdout);
+        }
+#endif
         
-        if (activity > 0 && FD_ISSET(server_sock, &readfds)) {
+        if (activity > 0 && (fds[0].revents & POLLIN)) {
             client_sock = malloc(sizeof(int));
             *client_sock = accept(server_sock, (struct sockaddr*)&client_addr, &client_len);
             if (*client_sock < 0) { 
@@ -416,156 +865,133 @@ int main(int argc, char *argv[]) {
     return 0;
 }
 
+// ASSIGN_MISSION with mission_id, target x/y and expiry patched in per assignment
+static FrameTemplate *create_mission_template(void) {
+    cJSON *js = cJSON_CreateObject();
+    cJSON_AddStringToObject(js, "type", "ASSIGN_MISSION");
+    cJSON_AddRawToObject(js, "mission_id", FRAME_SLOT);
+    cJSON_AddStringToObject(js, "priority", "medium");
+    cJSON *target = cJSON_CreateObject();
+    cJSON_AddRawToObject(target, "x", FRAME_SLOT);
+    cJSON_AddRawToObject(target, "y", FRAME_SLOT);
+    cJSON_AddItemToObject(js, "target", target);
+    cJSON_AddRawToObject(js, "expiry", FRAME_SLOT);
+    cJSON_AddStringToObject(js, "checksum", "a1b2c3");
+    FrameTemplate *tmpl = frame_template_create(js);
+    cJSON_Delete(js);
+    return tmpl;
+}
+
 // AI assigns survivors to idle drones
 void *ai_controller(void *arg) {
+    FrameTemplate *mission_template = create_mission_template();
     while (running) {
         // wait until at least one drone connected
-        pthread_mutex_lock(&drones_mutex);
+        mutex_lock(&drones_mutex);
         if (!drones->head) {
-            pthread_mutex_unlock(&drones_mutex);
+            mutex_unlock(&drones_mutex);
             sleep(1);
             continue;
         }
-        pthread_mutex_unlock(&drones_mutex);
-        // try priority queue first
+        mutex_unlock(&drones_mutex);
+        // try priority queue first. Only peek: the survivor stays queued
+        // (and in snapshots) until a drone takes it, and only this thread
+        // removes from either queue
         Survivor *s = NULL;
-        pthread_mutex_lock(&priority_mutex);
+        List *queue = NULL;
+        mutex_lock(&priority_mutex);
         // Get oldest orphan survivor (FIFO): use tail
         Node *pn = priority_survivors->tail;
         if (pn) {
             s = *(Survivor**)pn->data;
-            priority_survivors->removenode(priority_survivors, pn);
+            queue = priority_survivors;
         }
-        pthread_mutex_unlock(&priority_mutex);
+        metrics_gauge_set(GAUGE_SURVIVORS_PRIORITY, priority_survivors->number_of_elements);
+        mutex_unlock(&priority_mutex);
+        mutex_lock(&survivors_mutex);
         if (!s) {
-            pthread_mutex_lock(&survivors_mutex);
             Node *n = survivors->tail;
             if (n) {
                 s = *(Survivor**)n->data;
-                survivors->removenode(survivors, n);
+                queue = survivors;
             }
-            pthread_mutex_unlock(&survivors_mutex);
         }
+        metrics_gauge_set(GAUGE_SURVIVORS_WAITING, survivors->number_of_elements);
+        mutex_unlock(&survivors_mutex);
         if (!s) { sleep(1); continue; }
+        uint64_t dequeued_ns = monotonic_ns();
 
         // find closest idle drone
         Drone *best=NULL; int mind=INT_MAX;
-        pthread_mutex_lock(&drones_mutex);
+        mutex_lock(&drones_mutex);
         for (Node *dn = drones->head; dn; dn=dn->next) {
             Drone *d = *(Drone**)dn->data;
-            pthread_mutex_lock(&d->lock);
+            mutex_lock(&d->lock);
             if (d->status==IDLE) {
                 int dist=abs(d->coord.x-s->coord.x)+abs(d->coord.y-s->coord.y);
                 if (dist<mind) { mind=dist; best=d; }
             }
-            pthread_mutex_unlock(&d->lock);
+            mutex_unlock(&d->lock);
+        }
+        // Record the assignment while drones_mutex keeps the drone from being
+        // dropped; send it once the lock is released
+        int drone_sock = -1, drone_id = 0;
+        uint32_t mission_seq = 0;
+        if (best) {
+            static int mission_counter = 1;
+            mission_seq = (uint32_t)mission_counter++;
+            drone_sock = best->sockfd;
+            drone_id = best->id;
+            mutex_lock(&best->lock);
+            best->mission_seq = mission_seq;
+            best->mission_sent_ns = monotonic_ns();
+            set_drone_status(best, ON_MISSION);
+            best->target = s->coord;
+            mutex_unlock(&best->lock);
+            timer_schedule(&best->mission_timer, MISSION_EXPIRY * 1000);
+            // A drop requeues the survivor from helpedsurvivors under
+            // priority_mutex: hold it across the unlock so the survivor is
+            // listed before any drop can look for it
+            mutex_lock(&priority_mutex);
         }
-        pthread_mutex_unlock(&drones_mutex);
+        mutex_unlock(&drones_mutex);
         if (best) {
+            // Moved under priority_mutex, which snapshot_capture holds too:
+            // a snapshot sees it queued or helped, never neither
+            helpedsurvivors->add(helpedsurvivors,&s);
+            queue->removedata(queue, &s);
+            mutex_unlock(&priority_mutex);
             // record survivor wait time
             time_t now = time(NULL);
             time_t disc = mktime(&s->discovery_time);
             double wait = difftime(now, disc);
-            pthread_mutex_lock(&perf_mutex);
-            total_survivor_wait += wait;
-            total_survivors_assigned++;
-            pthread_mutex_unlock(&perf_mutex);
+            metrics_observe(HIST_SURVIVOR_WAIT, wait > 0 ? (uint64_t)(wait * 1e9) : 0);
             // send assign mission
-            int expiry = (int)time(NULL) + 300;
-            static int mission_counter = 1;
-            char mid[16]; snprintf(mid, sizeof(mid), "M%d", mission_counter++);
-            printf("[AI] Assigning survivor at (%d,%d) to drone %d\n", s->coord.x, s->coord.y, best->id);
-            cJSON *js = cJSON_CreateObject();
-            cJSON_AddStringToObject(js, "type", "ASSIGN_MISSION");
-            cJSON_AddStringToObject(js, "mission_id", mid);
-            cJSON_AddStringToObject(js, "priority", "medium");
-            cJSON *target = cJSON_CreateObject();
-            cJSON_AddNumberToObject(target, "x", s->coord.x);
-            cJSON_AddNumberToObject(target, "y", s->coord.y);
-            cJSON_AddItemToObject(js, "target", target);
-            cJSON_AddNumberToObject(js, "expiry", expiry);
-            cJSON_AddStringToObject(js, "checksum", "a1b2c3");
-            send_json(best->sockfd, js); cJSON_Delete(js);
-            pthread_mutex_lock(&best->lock);
-            best->status=ON_MISSION; 
-            best->target = s->coord;
-            pthread_mutex_unlock(&best->lock);
-            helpedsurvivors->add(helpedsurvivors,&s);
-        } else {
-            printf("[AI] No idle drone available for survivor at (%d,%d), requeue\n", s->coord.x, s->coord.y);
-            pthread_mutex_lock(&survivors_mutex);
-            survivors->add(survivors,&s);
-            pthread_mutex_unlock(&survivors_mutex);
+            int expiry = (int)time(NULL) + MISSION_EXPIRY;
+            log_info(LOG_MOD_AI, "[AI] Assigning survivor at (%d,%d) to drone %d\n", s->coord.x, s->coord.y, drone_id);
+            char mid_json[20], x_json[12], y_json[12], expiry_json[12];
+            snprintf(mid_json, sizeof(mid_json), "\"M%u\"", mission_seq);
+            snprintf(x_json, sizeof(x_json), "%d", s->coord.x);
+            snprintf(y_json, sizeof(y_json), "%d", s->coord.y);
+            snprintf(expiry_json, sizeof(expiry_json), "%d", expiry);
+            const char *fields[] = { mid_json, x_json, y_json, expiry_json };
+            PrintBuffer *out = thread_print_buffer();
+            size_t len = frame_template_render(mission_template, out, fields);
+            if (len) send_all(drone_sock, out->data, len);
+            uint64_t sent_ns = monotonic_ns();
+            flightrec_record(FR_ASSIGN, drone_id, s->coord.x, s->coord.y);
+            metrics_inc(CTR_TX_ASSIGN_MISSION);
+            metrics_observe(HIST_ASSIGNMENT_LATENCY, sent_ns - dequeued_ns);
+            trace_span("queued", mission_seq, drone_id, s->queued_ns, dequeued_ns);
+            trace_span("dispatch", mission_seq, drone_id, dequeued_ns, sent_ns);
         }
-        sleep(1);
-    }
-    return NULL;
-}
-
-// Heartbeat thread
-void *heartbeat_thread(void *arg) {
-    while (running) {
-        sleep(HEARTBEAT_INTERVAL);
-        cJSON *hb = cJSON_CreateObject();
-        cJSON_AddStringToObject(hb, "type", "HEARTBEAT");
-        cJSON_AddNumberToObject(hb, "timestamp", (int)time(NULL));
-        pthread_mutex_lock(&drones_mutex);
-        for (Node *n = drones->head; n; n = n->next) {
-            Drone *d = *(Drone **)n->data;
-            send_json(d->sockfd, hb);
+        if (!best) {
+            // Still at the tail of its queue for the next round
+            flightrec_record(FR_NO_IDLE_DRONE, s->coord.x, s->coord.y, 0);
+            log_debug(LOG_MOD_AI, "[AI] No idle drone available for survivor at (%d,%d), waiting\n", s->coord.x, s->coord.y);
         }
-        pthread_mutex_unlock(&drones_mutex);
-        cJSON_Delete(hb);
-    }
-    return NULL;
-}
-
-void* heartbeat_monitor(void *arg) {
-    while (running) {
-        sleep(HEARTBEAT_INTERVAL);
-        pthread_mutex_lock(&drones_mutex);
-        time_t now = time(NULL);
-        Node* n = drones->head;
-        while (n) {
-            Drone* d = *(Drone**)n->data;
-            if (now - d->last_heartbeat >= HEARTBEAT_INTERVAL) {
-                d->missed_heartbeats++;
-                if (d->missed_heartbeats >= 3) {
-                    printf("[SERVER] Drone %d missed 3 heartbeats, disconnecting\n", d->id);
-                    // requeue survivor mission from this drone, if any
-                    pthread_mutex_lock(&priority_mutex);
-                    for (Node* sn = helpedsurvivors->head; sn; sn = sn->next) {
-                        Survivor* sv = *(Survivor**)sn->data;
-                        if (sv->coord.x == d->target.x && sv->coord.y == d->target.y) {
-                            helpedsurvivors->removenode(helpedsurvivors, sn);
-                            priority_survivors->add(priority_survivors, &sv);
-                            break;
-                        }
-                    }
-                    pthread_mutex_unlock(&priority_mutex);
-                    Node* to_remove = n;
-                    n = n->next;
-                    drones->removenode(drones, to_remove);
-                    free(d);
-                    continue;
-                }
-            }
-            n = n->next;
-        }
-        pthread_mutex_unlock(&drones_mutex);
-    }
-    return NULL;
-}
-
-// Watchdog: shutdown if no drone messages in 60 seconds
-void* watchdog_thread(void *arg) {
-    while (running) {
         sleep(1);
-        if (time(NULL) - last_msg_time >= 60) {
-            printf("[SERVER] No drone activity for 60s, shutting down\n");
-            // terminate immediately to avoid threads accessing freed data
-            exit(EXIT_SUCCESS);
-        }
     }
+    frame_template_destroy(mission_template);
     return NULL;
 }
@@ -11,6 +11,10 @@
 #define DEFAULT_DRONE_SPEED 1
 #define DEFAULT_SURVIVOR_SPAWN_RATE 5
 #define DEFAULT_PORT 2100
+#define DEFAULT_HEARTBEAT_INTERVAL 10
+#define DEFAULT_ADMIN_PORT 9101
+#define DEFAULT_FEED_PORT 9102
+#define DEFAULT_FRAME_INTERVAL 0
 
 void print_server_banner(void) {
     printf("\n");
@@ -57,8 +61,21 @@ ServerConfig get_server_config(void) {
         .map_width = DEFAULT_MAP_WIDTH,    // Default map width
         .map_height = DEFAULT_MAP_HEIGHT,  // Default map height
         .survivor_spawn_rate = DEFAULT_SURVIVOR_SPAWN_RATE,  // Spawn rate
-        .drone_speed = DEFAULT_DRONE_SPEED // Default drone speed
+        .drone_speed = DEFAULT_DRONE_SPEED, // Default drone speed
+        .heartbeat_interval = DEFAULT_HEARTBEAT_INTERVAL,  // Advertised in HANDSHAKE_ACK
+        .admin_port = DEFAULT_ADMIN_PORT,  // GET /metrics on localhost
+        .feed_port = DEFAULT_FEED_PORT,    // Binary state stream for viewers
+        .frame_interval = DEFAULT_FRAME_INTERVAL  // Timelapse PNGs, off by default
     };
+    // FRAME_INTERVAL=<seconds> turns on timelapse frames
+    const char *frames = getenv("FRAME_INTERVAL");
+    if (frames && atoi(frames) > 0) config.frame_interval = atoi(frames);
+    // HEARTBEAT_INTERVAL=<seconds> overrides the probe interval the same way
+    const char *heartbeat = getenv("HEARTBEAT_INTERVAL");
+    if (heartbeat && atoi(heartbeat) > 0) config.heartbeat_interval = atoi(heartbeat);
+    // MAX_DRONES=<n> raises the fleet cap for load-generator runs
+    const char *max_drones = getenv("MAX_DRONES");
+    if (max_drones && atoi(max_drones) > 0) config.max_drones = atoi(max_drones);
     return config;
 }
 
@@ -69,4 +86,8 @@ void apply_server_config(ServerConfig config) {
     printf("  - Map Size: %dx%d\n", config.map_width, config.map_height);
     printf("  - Survivor Spawn Rate: %d seconds\n", config.survivor_spawn_rate);
     printf("  - Drone Speed: %d\n", config.drone_speed);
+    printf("  - Heartbeat Interval: %d seconds\n", config.heartbeat_interval);
+    printf("  - Admin Port: %d%s\n", config.admin_port, config.admin_port ? "" : " (disabled)");
+    printf("  - Feed Port: %d%s\n", config.feed_port, config.feed_port ? "" : " (disabled)");
+    printf("  - Frame Interval: %d seconds%s\n", config.frame_interval, config.frame_interval ? "" : " (disabled)");
 } 
\ No newline at end of file
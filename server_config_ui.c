@@ -79,6 +79,10 @@ ServerConfig get_server_config_sdl() {
         .max_drones = 64,
         .drone_speed = 1,
         .survivor_spawn_rate = 5,
+        .heartbeat_interval = 10,
+        .admin_port = 9101,
+        .feed_port = 9102,
+        .frame_interval = 0,
         .port = 2100
     };
 
@@ -221,6 +225,10 @@ void apply_server_config_sdl(ServerConfig config) {
     printf("Maximum Drones: %d\n", config.max_drones);
     printf("Drone Speed: %d\n", config.drone_speed);
     printf("Survivor Spawn Rate: %d seconds\n", config.survivor_spawn_rate);
+    printf("Heartbeat Interval: %d seconds\n", config.heartbeat_interval);
+    printf("Admin Port: %d\n", config.admin_port);
+    printf("Feed Port: %d\n", config.feed_port);
+    printf("Frame Interval: %d seconds\n", config.frame_interval);
     printf("Server Port: %d\n", config.port);
     printf("\n");
 } 
\ No newline at end of file
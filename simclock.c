@@ -0,0 +1,45 @@
+// Scaled or virtual clock for the drone client, see simclock.h
+#include "headers/simclock.h"
+#include <stdint.h>
+#include <errno.h>
+
+static double clock_scale = 1.0;
+static int virtual_mode;
+static time_t start_wall;
+static uint64_t start_mono_ns;
+static uint64_t virtual_elapsed_ms;     // virtual mode only, advanced atomically
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void simclock_init(double scale, int virtual_time) {
+    clock_scale = scale > 0 ? scale : 1.0;
+    virtual_mode = virtual_time;
+    start_wall = time(NULL);
+    start_mono_ns = mono_ns();
+}
+
+time_t simclock_now(void) {
+    if (virtual_mode)
+        return start_wall + (time_t)(__atomic_load_n(&virtual_elapsed_ms, __ATOMIC_RELAXED) / 1000);
+    if (clock_scale == 1.0) return time(NULL);
+    return start_wall + (time_t)((double)(mono_ns() - start_mono_ns) * clock_scale / 1e9);
+}
+
+unsigned long long simclock_wall_ns(unsigned long long ns) {
+    if (virtual_mode) return 0;
+    return (unsigned long long)((double)ns / clock_scale);
+}
+
+void simclock_sleep_ms(unsigned int ms) {
+    if (virtual_mode) {
+        __atomic_add_fetch(&virtual_elapsed_ms, ms, __ATOMIC_RELAXED);
+        return;
+    }
+    unsigned long long ns = simclock_wall_ns((unsigned long long)ms * 1000000ull);
+    struct timespec ts = { (time_t)(ns / 1000000000ull), (long)(ns % 1000000000ull) };
+    while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {}
+}
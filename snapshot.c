@@ -0,0 +1,106 @@
+// Triple-buffered world snapshot. The writer owns one buffer, the reader
+// owns one, and the third is the latest published copy; both sides swap
+// their buffer with the published one in a single atomic exchange, so
+// neither ever waits for the other.
+#include "headers/snapshot.h"
+#include <stdlib.h>
+#include "headers/globals.h"
+#include "headers/drone.h"
+#include "headers/survivor.h"
+#include "headers/lockprof.h"
+#include "headers/timer.h"
+
+#define FRESH 4                 // set in `published` until the reader takes it
+
+extern List *priority_survivors;
+extern pthread_mutex_t priority_mutex;
+
+static WorldSnapshot buffers[3];
+static int write_index = 0;     // writer only
+static int read_index = 1;      // reader only
+static int published = 2;       // buffer index, plus FRESH when unread
+
+static Timer snapshot_timer;
+
+static int reserve(void **items, int *capacity, int needed, size_t item_size) {
+    if (needed <= *capacity) return 0;
+    int grown = *capacity ? *capacity : 16;
+    while (grown < needed) grown *= 2;
+    void *p = realloc(*items, (size_t)grown * item_size);
+    if (!p) return -1;
+    *items = p;
+    *capacity = grown;
+    return 0;
+}
+
+static void capture_survivors(WorldSnapshot *snap, List *list, SnapshotSurvivorKind kind) {
+    if (!list) return;
+    mutex_lock(&list->lock);
+    if (reserve((void **)&snap->survivors, &snap->survivor_capacity,
+                snap->survivor_count + list->number_of_elements, sizeof(SnapshotSurvivor)) == 0) {
+        for (Node *n = list->head; n; n = n->next) {
+            Survivor *s = *(Survivor **)n->data;
+            if (!s) continue;
+            snap->survivors[snap->survivor_count++] = (SnapshotSurvivor){ s->id, s->coord, kind };
+        }
+    }
+    mutex_unlock(&list->lock);
+}
+
+void snapshot_capture(WorldSnapshot *snap) {
+    snap->map_width = map.width;
+    snap->map_height = map.height;
+    snap->drone_count = 0;
+    snap->survivor_count = 0;
+    if (drones) {
+        // drones->lock keeps drop_drone from freeing an entry under us
+        mutex_lock(&drones->lock);
+        if (reserve((void **)&snap->drones, &snap->drone_capacity,
+                    drones->number_of_elements, sizeof(SnapshotDrone)) == 0) {
+            for (Node *n = drones->head; n; n = n->next) {
+                Drone *d = *(Drone **)n->data;
+                if (!d) continue;
+                mutex_lock(&d->lock);
+                snap->drones[snap->drone_count++] = (SnapshotDrone){ d->id, d->status, d->coord, d->target };
+                mutex_unlock(&d->lock);
+            }
+        }
+        mutex_unlock(&drones->lock);
+    }
+    // Survivors move between these lists (queued -> helped, helped ->
+    // priority) under priority_mutex: holding it, each is copied exactly once
+    mutex_lock(&priority_mutex);
+    capture_survivors(snap, priority_survivors, SNAP_SURVIVOR_PRIORITY);
+    capture_survivors(snap, survivors, SNAP_SURVIVOR_WAITING);
+    capture_survivors(snap, helpedsurvivors, SNAP_SURVIVOR_HELPED);
+    mutex_unlock(&priority_mutex);
+    snap->taken_ns = monotonic_ns();
+}
+
+void snapshot_publish(void) {
+    WorldSnapshot *snap = &buffers[write_index];
+    snapshot_capture(snap);
+    static uint64_t seq;
+    snap->seq = ++seq;
+    int previous = __atomic_exchange_n(&published, write_index | FRESH, __ATOMIC_ACQ_REL);
+    write_index = previous & ~FRESH;
+}
+
+const WorldSnapshot *snapshot_acquire(void) {
+    if (__atomic_load_n(&published, __ATOMIC_ACQUIRE) & FRESH) {
+        int previous = __atomic_exchange_n(&published, read_index, __ATOMIC_ACQ_REL);
+        read_index = previous & ~FRESH;
+    }
+    return &buffers[read_index];
+}
+
+static void snapshot_expired(void *arg) {
+    snapshot_publish();
+    timer_schedule(&snapshot_timer, SNAPSHOT_INTERVAL_MS);
+}
+
+void snapshot_start(void) {
+    timer_init(&snapshot_timer, snapshot_expired, NULL);
+    snapshot_publish();
+    timer_schedule(&snapshot_timer, SNAPSHOT_INTERVAL_MS);
+}
@@ -9,6 +9,9 @@
 
 #include "headers/globals.h"
 #include "headers/map.h"
+#include "headers/lockprof.h"
+#include "headers/timer.h"
+#include "headers/log.h"
 
 extern List *priority_survivors;
 extern pthread_mutex_t priority_mutex;
@@ -19,11 +22,14 @@ Survivor *create_survivor(Coord *coord, char *info,
     if (!s) return NULL;
 
     memset(s, 0, sizeof(Survivor));
+    static uint32_t next_id;
+    s->id = __atomic_add_fetch(&next_id, 1, __ATOMIC_RELAXED);
     s->coord = *coord;
     memcpy(&s->discovery_time, discovery_time, sizeof(struct tm));
     strncpy(s->info, info, sizeof(s->info) - 1);
     s->info[sizeof(s->info) - 1] = '\0';  // Ensure null-termination
     s->status = 0;  // Initialize status (e.g., 0 for waiting)
+    s->queued_ns = monotonic_ns();
     return s;
 }
 
@@ -54,14 +60,14 @@ void *survivor_generator(void *args) {
         s->emergency_level = (rand() % 4 == 0) ? 1 : 0;
         int added = 0;
         if (s->emergency_level) {
-            pthread_mutex_lock(&priority_mutex);
+            mutex_lock(&priority_mutex);
             added = priority_survivors->add(priority_survivors, &s);
-            pthread_mutex_unlock(&priority_mutex);
+            mutex_unlock(&priority_mutex);
         } else {
             added = survivors->add(survivors, &s);
         }
         if (!added) {
-            fprintf(stderr, "Survivor Generator: Failed to add survivor (full?) level=%d\n", s->emergency_level);
+            log_warn(LOG_MOD_SERVER, "Survivor Generator: Failed to add survivor (full?) level=%d\n", s->emergency_level);
             free(s);
             sleep(1);
             continue;
@@ -73,7 +79,7 @@ void *survivor_generator(void *args) {
             Node* added_node_cell = map.cells[cell_coord.x][cell_coord.y].survivors->add(
                 map.cells[cell_coord.x][cell_coord.y].survivors, &s);
             if (!added_node_cell) {
-                 fprintf(stderr, "Survivor Generator: Failed to add to map cell [%d][%d] survivors list (full?)\n", cell_coord.x, cell_coord.y);
+                 log_warn(LOG_MOD_SERVER, "Survivor Generator: Failed to add to map cell [%d][%d] survivors list (full?)\n", cell_coord.x, cell_coord.y);
                  // If adding to cell list fails, we might want to remove from global list too, or handle inconsistency.
                  // For now, just note the error. The survivor is still in the global list.
                  // Consider removing from global list if cell add fails and it's critical:
@@ -82,10 +88,10 @@ void *survivor_generator(void *args) {
                  // A robust solution would be to ensure s is only freed once, or not added globally if cell add is required.
             }
         } else {
-            fprintf(stderr, "Survivor Generator: Invalid coordinates (%d,%d) for map cell access.\n", cell_coord.x, cell_coord.y);
+            log_warn(LOG_MOD_SERVER, "Survivor Generator: Invalid coordinates (%d,%d) for map cell access.\n", cell_coord.x, cell_coord.y);
         }
 
-        printf("New survivor at (%d,%d): %s\n", s->coord.x, s->coord.y, s->info);
+        log_debug(LOG_MOD_SERVER, "New survivor at (%d,%d): %s\n", s->coord.x, s->coord.y, s->info);
         
         // Check running flag before sleep to allow quicker exit
         if (!running) break;
@@ -0,0 +1,165 @@
+// feed_tick's diff against the real snapshot_capture and survivor lists.
+// A survivor found twice in one copy (a move between lists that skipped
+// priority_mutex) must reach the subscriber as helped, never gone; and a
+// survivor the AI moves between lists under priority_mutex must never look
+// gone, however the copies interleave with the moves. Builds feed.c and
+// snapshot.c directly with stand-ins for the rest of the server; the
+// subscriber is one end of a socketpair. Run by "make test".
+#include "../feed.c"
+#include "../snapshot.c"
+
+volatile sig_atomic_t running = 1;
+LogLevel log_levels[LOG_MODULE_COUNT];
+Map map;
+List *survivors, *helpedsurvivors, *drones, *priority_survivors;
+pthread_mutex_t priority_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void log_write(LogModule module, LogLevel level, const char *format, ...) {}
+void metrics_add(CounterId id, uint64_t value) {}
+void metrics_gauge_add(GaugeId id, int64_t delta) {}
+uint64_t monotonic_ns(void) { return 0; }
+void timer_init(Timer *timer, TimerCallback callback, void *arg) {}
+void timer_schedule(Timer *timer, unsigned int delay_ms) {}
+
+static int failures;
+
+static void expect(int ok, const char *what) {
+    if (!ok) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+typedef struct {
+    int survivors, gone, ticks, other;
+    uint32_t last_id;
+    int last_kind;
+} Batch;
+
+// Decode everything the subscriber has been sent since the last call
+static Batch read_batch(int fd) {
+    uint8_t buf[4096];
+    Batch b = {0};
+    ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    for (ssize_t i = 0; i < n;) {
+        switch (buf[i]) {
+            case FEED_HELLO: i += FEED_HELLO_SIZE; break;
+            case FEED_SURVIVOR:
+                b.survivors++;
+                b.last_id = get_u32(buf + i + 1);
+                b.last_kind = buf[i + 5];
+                i += FEED_SURVIVOR_SIZE;
+                break;
+            case FEED_SURVIVOR_GONE: b.gone++; i += FEED_GONE_SIZE; break;
+            case FEED_TICK: b.ticks++; i += FEED_TICK_SIZE; break;
+            default: b.other++; i = n; break;
+        }
+    }
+    return b;
+}
+
+static Survivor *survivor(uint32_t id, int x, int y) {
+    Survivor *s = calloc(1, sizeof(Survivor));
+    s->id = id;
+    s->coord = (Coord){x, y};
+    return s;
+}
+
+// The AI's and requeue_mission's move between lists. Out of one list and,
+// a moment later, into the other: under priority_mutex no copy sees the gap
+static void move(Survivor *s, List *from, List *to) {
+    mutex_lock(&priority_mutex);
+    from->removedata(from, &s);
+    usleep(20);
+    to->add(to, &s);
+    mutex_unlock(&priority_mutex);
+}
+
+#define MOVES 5000
+
+static int moves;
+
+// Survivor 9 round the lists as the server moves it: waiting -> helped
+// (assigned) -> priority (its drone lost) -> helped -> ...
+static void *mover(void *arg) {
+    Survivor *s = arg;
+    survivors->add(survivors, &s);
+    move(s, survivors, helpedsurvivors);
+    while (__atomic_load_n(&moves, __ATOMIC_RELAXED) < MOVES) {
+        usleep(20);
+        move(s, helpedsurvivors, priority_survivors);
+        usleep(20);
+        move(s, priority_survivors, helpedsurvivors);
+        __atomic_add_fetch(&moves, 2, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+int main(void) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) {
+        perror("socketpair");
+        return 1;
+    }
+    for (int i = 0; i < FEED_MAX_SUBSCRIBERS; i++) subscribers[i].fd = -1;
+    subscribers[0].fd = pair[0];
+    subscriber_count = 1;
+    map.width = map.height = 10;
+    survivors = create_list(sizeof(Survivor *), 8);
+    helpedsurvivors = create_list(sizeof(Survivor *), 8);
+    priority_survivors = create_list(sizeof(Survivor *), 8);
+
+    // Full sync: survivor 5 waiting, 7 in the priority queue
+    Survivor *five = survivor(5, 2, 2), *seven = survivor(7, 1, 1);
+    survivors->add(survivors, &five);
+    priority_survivors->add(priority_survivors, &seven);
+    feed_tick();
+    Batch b = read_batch(pair[1]);
+    expect(b.survivors == 2 && b.gone == 0 && b.ticks == 1 && b.other == 0, "full snapshot has both survivors");
+
+    // 7 is listed both as priority and as helped
+    helpedsurvivors->add(helpedsurvivors, &seven);
+    feed_tick();
+    b = read_batch(pair[1]);
+    expect(b.gone == 0, "duplicate id is not reported gone");
+    expect(b.survivors == 1 && b.last_id == 7 && b.last_kind == SNAP_SURVIVOR_HELPED, "duplicate id resolves to helped");
+
+    // Once the priority entry is gone the subscriber already has it right
+    priority_survivors->removedata(priority_survivors, &seven);
+    feed_tick();
+    b = read_batch(pair[1]);
+    expect(b.survivors == 0 && b.gone == 0 && b.ticks == 1, "clean copy after the duplicate sends no changes");
+
+    // A duplicate between two clean copies changes nothing either way
+    priority_survivors->add(priority_survivors, &seven);
+    feed_tick();
+    priority_survivors->removedata(priority_survivors, &seven);
+    feed_tick();
+    b = read_batch(pair[1]);
+    expect(b.survivors == 0 && b.gone == 0 && b.ticks == 2, "duplicate between clean copies sends no changes");
+
+    // Survivor 9 moving between lists while the feed copies them
+    pthread_t tid;
+    pthread_create(&tid, NULL, mover, survivor(9, 3, 3));
+    int gone = 0, ticks = 0;
+    while (__atomic_load_n(&moves, __ATOMIC_RELAXED) < MOVES) {
+        feed_tick();
+        b = read_batch(pair[1]);
+        gone += b.gone;
+        ticks += b.ticks;
+    }
+    pthread_join(tid, NULL);
+    expect(ticks > MOVES / 10, "feed ticked while the survivor moved");
+    expect(gone == 0, "survivor moving between lists is never reported gone");
+
+    if (failures) {
+        printf("feed_merge: %d checks failed\n", failures);
+        return 1;
+    }
+    printf("feed_merge: ok\n");
+    return 0;
+}
@@ -0,0 +1,36 @@
+#!/bin/sh
+# Heartbeat phasing check (make test-heartbeat): DRONES idle load-generator
+# drones connect in the same instant to a headless server probing every
+# INTERVAL seconds. They send no STATUS_UPDATE, so every drone is probed once
+# per interval. The HEARTBEATs they receive per second must stay flat: no
+# empty second and no second above MAX_RATIO times the mean. Without
+# staggering, the whole fleet is probed in one second of each interval.
+# Needs ./server and ./drone_client built, and port 2100 and 9101 free.
+DRONES=${DRONES:-50}
+INTERVAL=${INTERVAL:-2}
+DURATION=${DURATION:-20}
+MAX_RATIO=${MAX_RATIO:-2.5}
+cd "$(dirname "$0")/.." || exit 1
+
+HEARTBEAT_INTERVAL=$INTERVAL ./server --headless > /tmp/heartbeat_phasing_server.log 2>&1 &
+server_pid=$!
+trap 'kill $server_pid 2>/dev/null' EXIT INT TERM
+sleep 1
+
+./drone_client --load -n "$DRONES" -r 0 -u 3600000 -t "$DURATION" > /tmp/heartbeat_phasing_load.log 2>&1
+
+# per-second rx/s HEARTBEAT values, skipping the first probes (interval/2 to 1.5 intervals in)
+grep '^\[LOAD\]' /tmp/heartbeat_phasing_load.log |
+    sed -n 's/.*HEARTBEAT \([0-9.]*\) |.*/\1/p' |
+    awk -v skip="$(( INTERVAL * 2 ))" -v drones="$DRONES" -v interval="$INTERVAL" -v max_ratio="$MAX_RATIO" '
+    NR > skip { rate[++n] = $1; sum += $1; if ($1 > max) max = $1; if ($1 == 0) empty++ }
+    END {
+        if (n < interval * 3) { print "heartbeat_phasing: FAIL, only " n " seconds of samples"; exit 1 }
+        mean = sum / n
+        line = ""
+        for (i = 1; i <= n; i++) line = line " " rate[i]
+        printf "heartbeat_phasing: %d drones, %ds interval, HEARTBEAT/s:%s\n", drones, interval, line
+        printf "heartbeat_phasing: mean %.1f/s (expected %.1f), max %.1f/s, %d empty seconds\n", mean, drones / interval, max, empty
+        if (empty > 0 || max > mean * max_ratio || mean < drones / interval / 2) { print "heartbeat_phasing: FAIL"; exit 1 }
+        print "heartbeat_phasing: ok"
+    }'
@@ -0,0 +1,87 @@
+// print_number must produce text that strtod reads back to the same double,
+// and integers must print exactly as "%1.15g" printed them before the
+// Grisu2/format_integer rewrite. Run by "make test".
+//   tests/number_roundtrip [random_doubles]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+#include "cJSON.h"
+
+#define TEST_DEFAULT_RANDOM 1000000
+
+static unsigned long long failures;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void check_value(double value) {
+    cJSON *item = cJSON_CreateNumber(value);
+    char *text = cJSON_PrintUnformatted(item);
+    double back = text ? strtod(text, NULL) : NAN;
+    int ok = text && (back == value) && (value != 0 || back == 0);
+    if (ok && value != 0) ok = memcmp(&back, &value, sizeof(double)) == 0;
+    if (ok && value == floor(value) && fabs(value) < 1e15) {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%1.15g", value);
+        if (strcmp(expected, "-0") == 0) strcpy(expected, "0");
+        ok = strcmp(text, expected) == 0;
+    }
+    if (!ok && failures++ < 20) {
+        fprintf(stderr, "FAIL %.17g printed as %s\n", value, text ? text : "(null)");
+    }
+    cJSON_free(text);
+    cJSON_Delete(item);
+}
+
+int main(int argc, char *argv[]) {
+    long random_count = argc > 1 ? atol(argv[1]) : TEST_DEFAULT_RANDOM;
+    unsigned long long checked = 0;
+
+    static const double edges[] = {
+        0.0, -0.0, 1.0, -1.0, 0.1, 0.2, 0.3, 1.0 / 3.0, 2.0 / 3.0, 5e-324, -5e-324,
+        DBL_MIN, DBL_MAX, -DBL_MAX, DBL_EPSILON, 1e-7, 1e21, 1e22, 1e23, 123456789012345678.0,
+        9007199254740991.0, 9007199254740993.0, 4294967295.0, 2147483647.0, -2147483648.0,
+        2147483648.0, 1e15, 1e16, 1e17, 0.5, 1.5, 2.5, 1620000000.5, 85.25, 1.7976931348623157e308,
+        2.2250738585072009e-308, 4.9406564584124654e-324
+    };
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++, checked++) check_value(edges[i]);
+
+    // powers of ten and their neighbours, the classic shortest-digits traps
+    for (int e = -307; e <= 308; e++, checked += 3) {
+        double p = pow(10.0, e);
+        check_value(p);
+        check_value(nextafter(p, 0));
+        check_value(nextafter(p, INFINITY));
+    }
+    // every integer the protocol sends is small; these must match "%1.15g" exactly
+    for (int i = -100000; i <= 100000; i++, checked++) check_value((double)i);
+    // random bit patterns cover every exponent, including subnormals
+    for (long i = 0; i < random_count; i++) {
+        uint64_t bits = rng_next();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (isnan(value) || isinf(value)) continue;
+        check_value(value);
+        checked++;
+    }
+    // random values in the range coordinates and timestamps live in
+    for (long i = 0; i < random_count; i++, checked++) {
+        check_value((double)(rng_next() >> 11) / 9007199254740992.0 * 2e9 - 1e9);
+    }
+
+    if (failures) {
+        printf("number_roundtrip: %llu of %llu values failed\n", failures, checked);
+        return 1;
+    }
+    printf("number_roundtrip: %llu values ok\n", checked);
+    return 0;
+}
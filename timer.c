@@ -0,0 +1,170 @@
+// Hierarchical timing wheel: one thread serves every liveness, reconnect and
+// mission deadline. Insert and cancel are O(1); each tick only touches the
+// timers that expire (plus an occasional cascade of one coarser slot).
+#include "headers/timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include "headers/globals.h"
+
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS 4   // 64^4 ticks of 100ms, about 19 days
+
+static Timer *wheel[WHEEL_LEVELS][WHEEL_SIZE];
+static uint64_t current_tick;   // next tick to be processed
+static pthread_mutex_t timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void link_timer(Timer **head, Timer *timer) {
+    timer->next = *head;
+    if (*head) (*head)->pprev = &timer->next;
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void unlink_timer(Timer *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next) timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// Place timer in the level whose span covers its remaining delay
+static void insert_timer(Timer *timer) {
+    uint64_t expires = timer->expires;
+    uint64_t delta = expires - current_tick;
+    if ((int64_t)delta < 0) {
+        // Already due: fire on the next tick
+        link_timer(&wheel[0][current_tick & WHEEL_MASK], timer);
+        return;
+    }
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        if (delta < ((uint64_t)1 << (WHEEL_BITS * (level + 1)))) {
+            link_timer(&wheel[level][(expires >> (WHEEL_BITS * level)) & WHEEL_MASK], timer);
+            return;
+        }
+    }
+    // Beyond the wheel's range: park in the farthest slot, it is re-cascaded from there
+    timer->expires = current_tick + ((uint64_t)1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+    link_timer(&wheel[WHEEL_LEVELS - 1][(timer->expires >> (WHEEL_BITS * (WHEEL_LEVELS - 1))) & WHEEL_MASK], timer);
+}
+
+// Redistribute one slot of a coarser level into the finer levels
+static int cascade(int level) {
+    int index = (int)((current_tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+    Timer *list = wheel[level][index];
+    wheel[level][index] = NULL;
+    while (list) {
+        Timer *timer = list;
+        list = timer->next;
+        timer->next = NULL;
+        timer->pprev = NULL;
+        insert_timer(timer);
+    }
+    return index;
+}
+
+// Process current_tick: cascade when a level wraps, then fire what is due.
+// Called with timer_mutex held; returns with it held.
+static void run_tick(void) {
+    int index = (int)(current_tick & WHEEL_MASK);
+    if (index == 0) {
+        for (int level = 1; level < WHEEL_LEVELS && cascade(level) == 0; level++)
+            ;
+    }
+    // Move the due timers to a local list so callbacks can (re)arm freely
+    Timer *due = NULL;
+    Timer *list = wheel[0][index];
+    wheel[0][index] = NULL;
+    while (list) {
+        Timer *timer = list;
+        list = timer->next;
+        link_timer(&due, timer);
+    }
+    current_tick++;
+    while (due) {
+        Timer *timer = due;
+        unlink_timer(timer);
+        TimerCallback callback = timer->callback;
+        void *arg = timer->arg;
+        pthread_mutex_unlock(&timer_mutex);
+        callback(arg);
+        pthread_mutex_lock(&timer_mutex);
+    }
+}
+
+uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t monotonic_ms(void) {
+    return monotonic_ns() / 1000000;
+}
+
+static uint64_t start_ms;
+
+static void *timer_thread(void *arg) {
+    while (running) {
+        uint64_t target = (monotonic_ms() - start_ms) / TIMER_TICK_MS;
+        pthread_mutex_lock(&timer_mutex);
+        while (current_tick <= target) run_tick();
+        pthread_mutex_unlock(&timer_mutex);
+        // Sleep until the start of the next tick
+        uint64_t next_ms = start_ms + (target + 1) * TIMER_TICK_MS;
+        uint64_t now = monotonic_ms();
+        if (next_ms > now) {
+            struct timespec ts = { (time_t)((next_ms - now) / 1000), (long)((next_ms - now) % 1000) * 1000000L };
+            while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+                ;
+        }
+    }
+    return NULL;
+}
+
+void timer_service_start(void) {
+    pthread_t tid;
+    start_ms = monotonic_ms();
+    current_tick = 0;
+    if (pthread_create(&tid, NULL, timer_thread, NULL) != 0) {
+        perror("timer thread");
+        exit(EXIT_FAILURE);
+    }
+    pthread_detach(tid);
+}
+
+void timer_init(Timer *timer, TimerCallback callback, void *arg) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+void timer_schedule(Timer *timer, unsigned int delay_ms) {
+    // Round up so a timer never fires early
+    uint64_t ticks = (delay_ms + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+    pthread_mutex_lock(&timer_mutex);
+    if (timer->pprev) unlink_timer(timer);
+    // current_tick is the next tick to run, which may be partly elapsed already
+    timer->expires = current_tick + ticks;
+    insert_timer(timer);
+    pthread_mutex_unlock(&timer_mutex);
+}
+
+void timer_cancel(Timer *timer) {
+    pthread_mutex_lock(&timer_mutex);
+    if (timer->pprev) unlink_timer(timer);
+    pthread_mutex_unlock(&timer_mutex);
+}
+
+bool timer_pending(Timer *timer) {
+    pthread_mutex_lock(&timer_mutex);
+    bool pending = timer->pprev != NULL;
+    pthread_mutex_unlock(&timer_mutex);
+    return pending;
+}
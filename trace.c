@@ -0,0 +1,125 @@
+// Mission span recorder: single-writer rings, one per thread, read without
+// stopping the writers (seqlock-style: spans overwritten during the read
+// are detected from the head index and skipped).
+#include "headers/trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+typedef struct {
+    const char *name;
+    uint32_t mission;
+    int drone_id;
+    uint64_t start_ns;
+    uint64_t end_ns;
+} TraceSpan;
+
+typedef struct trace_ring {
+    uint64_t head;              // spans ever written; published with release
+    int in_use;                 // owned by a live thread
+    struct trace_ring *next;
+    TraceSpan spans[TRACE_RING_SIZE];
+} TraceRing;
+
+static TraceRing *rings;
+static pthread_mutex_t rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t ring_key;
+static pthread_once_t ring_once = PTHREAD_ONCE_INIT;
+
+// Thread exit: keep the spans, hand the ring to the next new thread
+static void release_ring(void *arg) {
+    TraceRing *ring = arg;
+    pthread_mutex_lock(&rings_mutex);
+    ring->in_use = 0;
+    pthread_mutex_unlock(&rings_mutex);
+}
+
+static void create_ring_key(void) {
+    pthread_key_create(&ring_key, release_ring);
+}
+
+static TraceRing *thread_ring(void) {
+    pthread_once(&ring_once, create_ring_key);
+    TraceRing *ring = pthread_getspecific(ring_key);
+    if (ring) return ring;
+    pthread_mutex_lock(&rings_mutex);
+    for (ring = rings; ring && ring->in_use; ring = ring->next)
+        ;
+    if (!ring) {
+        ring = calloc(1, sizeof(TraceRing));
+        if (ring) {
+            ring->next = rings;
+            rings = ring;
+        }
+    }
+    if (ring) ring->in_use = 1;
+    pthread_mutex_unlock(&rings_mutex);
+    if (ring) pthread_setspecific(ring_key, ring);
+    return ring;
+}
+
+void trace_span(const char *name, uint32_t mission, int drone_id, uint64_t start_ns, uint64_t end_ns) {
+    TraceRing *ring = thread_ring();
+    if (!ring) return;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    TraceSpan *span = &ring->spans[head % TRACE_RING_SIZE];
+    span->name = name;
+    span->mission = mission;
+    span->drone_id = drone_id;
+    span->start_ns = start_ns;
+    span->end_ns = end_ns;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Copy a ring's valid spans; returns how many were appended to out
+static size_t copy_ring(TraceRing *ring, TraceSpan *out) {
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+    size_t n = 0;
+    for (uint64_t i = first; i < head; i++) out[n++] = ring->spans[i % TRACE_RING_SIZE];
+    // Drop whatever the writer lapped while we were copying, including the
+    // slot it may be filling right now (index head + 1 - size)
+    uint64_t now = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) + 1;
+    uint64_t overwritten = now > first + TRACE_RING_SIZE ? now - TRACE_RING_SIZE - first : 0;
+    if (overwritten >= n) return 0;
+    memmove(out, out + overwritten, (n - overwritten) * sizeof(TraceSpan));
+    return n - overwritten;
+}
+
+static int by_mission(const void *a, const void *b) {
+    const TraceSpan *x = a, *y = b;
+    if (x->mission != y->mission) return x->mission < y->mission ? -1 : 1;
+    return x->start_ns < y->start_ns ? -1 : x->start_ns > y->start_ns;
+}
+
+void trace_write_chrome(FILE *out) {
+    pthread_mutex_lock(&rings_mutex);
+    size_t ring_count = 0;
+    for (TraceRing *ring = rings; ring; ring = ring->next) ring_count++;
+    TraceSpan *spans = malloc((ring_count ? ring_count : 1) * TRACE_RING_SIZE * sizeof(TraceSpan));
+    size_t count = 0;
+    if (spans) {
+        for (TraceRing *ring = rings; ring; ring = ring->next) count += copy_ring(ring, spans + count);
+    }
+    pthread_mutex_unlock(&rings_mutex);
+    if (!spans) return;
+    // Group by mission so each one gets a single named track
+    qsort(spans, count, sizeof(TraceSpan), by_mission);
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    const char *sep = "";
+    for (size_t i = 0; i < count; i++) {
+        TraceSpan *s = &spans[i];
+        if (i == 0 || spans[i - 1].mission != s->mission) {
+            fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"mission M%u\"}}",
+                    sep, s->mission, s->mission);
+            sep = ",";
+        }
+        fprintf(out, "%s\n{\"name\":\"%s\",\"cat\":\"mission\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"drone\":%d}}",
+                sep, s->name, s->mission, s->start_ns / 1e3,
+                (s->end_ns > s->start_ns ? s->end_ns - s->start_ns : 0) / 1e3, s->drone_id);
+        sep = ",";
+    }
+    fprintf(out, "\n]}\n");
+    free(spans);
+}
@@ -1,18 +1,30 @@
 #include "headers/view.h"
 #include <SDL2/SDL.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 #include "headers/drone.h"
 #include "headers/map.h"
 #include "headers/survivor.h"
+#include "headers/lockprof.h"
+#include "headers/metrics.h"
+#include "headers/timer.h"
 
-#define CELL_SIZE 20  // Pixels per map cell
+#define CELL_SIZE 20  // Pixels per map cell at the default zoom
+
+// Large maps are shown through a scrollable, zoomable viewport
+#define VIEW_MAX_WIDTH 1280   // initial window size limit
+#define VIEW_MAX_HEIGHT 800
+#define GRID_MIN_PX 8         // no grid lines below this cell size
+#define LOD_MAX_PX 4          // below this cell size, draw density tiles
+#define LOD_TILE_PX 8         // density tile size on screen
+#define LOD_LEVELS 4          // density shades: 1, 2-3, 4-7, 8+ per tile
 
 // SDL globals
 SDL_Window* window = NULL;
 SDL_Renderer* renderer = NULL;
-// Include priority queue for disconnected missions
-extern List *priority_survivors;
 SDL_Event event;
 int window_width, window_height;
 
@@ -30,10 +42,77 @@ const SDL_Color PURPLE = {128, 0, 128, 255};    // Helped survivors
 pthread_mutex_t sdl_mutex = PTHREAD_MUTEX_INITIALIZER;
 volatile int sdl_ready = 0;
 
+// Viewport, owned by the render thread: zoom level and the map position at
+// the window's top-left corner, in cells (column = coord.y, row = coord.x)
+static const double zoom_steps[] = {0.125, 0.25, 0.5, 1, 2, 4, 6, 8, 12, 16, 20, 24, 32, 40};
+#define ZOOM_STEPS (int)(sizeof(zoom_steps) / sizeof(zoom_steps[0]))
+static int zoom_index;
+static double view_col, view_row;
+
+// Per-frame transform: screen x of column c is floor(c * cell) - origin_x
+static double cell;
+static int origin_x, origin_y;
+
+static void view_clamp(void) {
+    double cell_px = zoom_steps[zoom_index];
+    double spare_cols = map.width - window_width / cell_px;
+    double spare_rows = map.height - window_height / cell_px;
+    // Center a map smaller than the window, otherwise keep it covering the view
+    if (spare_cols < 0) view_col = spare_cols / 2;
+    else view_col = view_col < 0 ? 0 : view_col > spare_cols ? spare_cols : view_col;
+    if (spare_rows < 0) view_row = spare_rows / 2;
+    else view_row = view_row < 0 ? 0 : view_row > spare_rows ? spare_rows : view_row;
+}
+
+// Largest zoom up to CELL_SIZE that shows the whole map
+static void view_fit(void) {
+    zoom_index = 0;
+    for (int i = 0; i < ZOOM_STEPS && zoom_steps[i] <= CELL_SIZE; i++) {
+        if (map.width * zoom_steps[i] <= window_width && map.height * zoom_steps[i] <= window_height) zoom_index = i;
+    }
+    view_col = view_row = 0;
+    view_clamp();
+}
+
+// Zoom by steps keeping the map point under (px, py) in place
+static void view_zoom(int steps, int px, int py) {
+    int index = zoom_index + steps;
+    if (index < 0) index = 0;
+    if (index >= ZOOM_STEPS) index = ZOOM_STEPS - 1;
+    double col = view_col + px / zoom_steps[zoom_index];
+    double row = view_row + py / zoom_steps[zoom_index];
+    zoom_index = index;
+    view_col = col - px / zoom_steps[zoom_index];
+    view_row = row - py / zoom_steps[zoom_index];
+    view_clamp();
+}
+
+static void view_pan_pixels(int dx, int dy) {
+    view_col += dx / zoom_steps[zoom_index];
+    view_row += dy / zoom_steps[zoom_index];
+    view_clamp();
+}
+
+// Screen rectangle of map cell (x = row, y = column); 0 if off screen
+static int cell_rect(int x, int y, SDL_Rect *rect) {
+    int left = (int)floor(y * cell) - origin_x;
+    int top = (int)floor(x * cell) - origin_y;
+    int size = cell < 1 ? 1 : (int)cell;
+    if (left + size <= 0 || top + size <= 0 || left >= window_width || top >= window_height) return 0;
+    *rect = (SDL_Rect){ left, top, size, size };
+    return 1;
+}
+
+static void begin_frame(void) {
+    cell = zoom_steps[zoom_index];
+    origin_x = (int)floor(view_col * cell);
+    origin_y = (int)floor(view_row * cell);
+}
+
 // Function to be called from main thread to initialize SDL
 int init_sdl_main_thread() {
-    window_width = map.width * CELL_SIZE;
-    window_height = map.height * CELL_SIZE;
+    window_width = map.width * CELL_SIZE < VIEW_MAX_WIDTH ? map.width * CELL_SIZE : VIEW_MAX_WIDTH;
+    window_height = map.height * CELL_SIZE < VIEW_MAX_HEIGHT ? map.height * CELL_SIZE : VIEW_MAX_HEIGHT;
 
     printf("Initializing SDL window (%dx%d)\n", window_width, window_height);
 
@@ -50,7 +129,7 @@ int init_sdl_main_thread() {
                             SDL_WINDOWPOS_CENTERED, 
                             window_width,
                             window_height, 
-                            SDL_WINDOW_SHOWN);
+                            SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
     if (!window) {
         fprintf(stderr, "SDL_CreateWindow Error: %s\n", SDL_GetError());
         SDL_Quit();
@@ -73,6 +152,7 @@ int init_sdl_main_thread() {
         }
     }
 
+    view_fit();
     sdl_ready = 1;
     return 0;
 }
@@ -95,113 +175,238 @@ int init_sdl_window() {
 
 // Thread-safe drawing functions
 void draw_cell(int x, int y, SDL_Color color) {
-    pthread_mutex_lock(&sdl_mutex);
+    mutex_lock(&sdl_mutex);
     if (!sdl_ready) {
-        pthread_mutex_unlock(&sdl_mutex);
+        mutex_unlock(&sdl_mutex);
         return;
     }
     
-    SDL_Rect rect = {
-        .x = y * CELL_SIZE,
-        .y = x * CELL_SIZE,
-        .w = CELL_SIZE,
-        .h = CELL_SIZE
-    };
+    SDL_Rect rect;
+    if (!cell_rect(x, y, &rect)) {
+        mutex_unlock(&sdl_mutex);
+        return;
+    }
     
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
     SDL_RenderFillRect(renderer, &rect);
-    pthread_mutex_unlock(&sdl_mutex);
+    mutex_unlock(&sdl_mutex);
 }
 
-void draw_target_marker(int x, int y) {
-    // Draw a cross at the target location
-    SDL_SetRenderDrawColor(renderer, YELLOW.r, YELLOW.g, YELLOW.b, YELLOW.a);
-    int center_x = y * CELL_SIZE + CELL_SIZE / 2;
-    int center_y = x * CELL_SIZE + CELL_SIZE / 2;
-    int size = CELL_SIZE / 4;
-    
-    SDL_RenderDrawLine(renderer, center_x - size, center_y, center_x + size, center_y);
-    SDL_RenderDrawLine(renderer, center_x, center_y - size, center_x, center_y + size);
+// Rectangles of one color collected over a frame and drawn with a single
+// SDL_RenderFillRects call
+typedef struct {
+    SDL_Rect *rects;
+    int count, capacity;
+} RectBatch;
+
+enum {
+    BATCH_ORANGE, BATCH_RED, BATCH_PURPLE, BATCH_BLUE, BATCH_GREEN, BATCH_YELLOW, BATCH_WHITE,
+    BATCH_LOD_SURVIVORS,                            // LOD_LEVELS shades each
+    BATCH_LOD_DRONES = BATCH_LOD_SURVIVORS + LOD_LEVELS,
+    BATCH_COUNT = BATCH_LOD_DRONES + LOD_LEVELS
+};
+static RectBatch batches[BATCH_COUNT];
+
+static const SDL_Color LOD_SURVIVOR_SHADES[LOD_LEVELS] = {
+    {110, 0, 0, 255}, {170, 0, 0, 255}, {230, 30, 30, 255}, {255, 110, 110, 255}};
+static const SDL_Color LOD_DRONE_SHADES[LOD_LEVELS] = {
+    {0, 0, 140, 255}, {0, 0, 200, 255}, {40, 40, 255, 255}, {120, 120, 255, 255}};
+
+// Grid lines are periodic: drawn once per zoom level into a transparent
+// texture one cell larger than the window, then blitted at the sub-cell offset
+static SDL_Texture *grid_texture;
+static int grid_texture_failed;
+static int grid_cell, grid_width, grid_height;
+
+// Density tile counts for the LOD view, sized to the window
+static int *lod_survivors, *lod_drones;
+static int lod_capacity;
+
+static void batch_add(RectBatch *b, int x, int y, int w, int h) {
+    if (b->count == b->capacity) {
+        int capacity = b->capacity ? b->capacity * 2 : 64;
+        SDL_Rect *rects = realloc(b->rects, (size_t)capacity * sizeof(SDL_Rect));
+        if (!rects) return;
+        b->rects = rects;
+        b->capacity = capacity;
+    }
+    b->rects[b->count++] = (SDL_Rect){ x, y, w, h };
 }
 
-void draw_drones() {
-    // Yeni: merkezi List *drones yapısını kullan
-    extern List *drones;
-    if (!drones) return;
-    pthread_mutex_lock(&drones->lock);
-    Node *node = drones->head;
-    while (node) {
-        Drone *drone = *(Drone **)node->data;
-        if (!drone) { node = node->next; continue; }
-        SDL_Color color = (drone->status == IDLE) ? BLUE : GREEN;
-        draw_cell(drone->coord.x, drone->coord.y, color);
-        draw_target_marker(drone->target.x, drone->target.y);
-        // Draw line to target if on mission
-        if (drone->status == ON_MISSION) {
-            SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
-            int x1 = drone->coord.y * CELL_SIZE + CELL_SIZE/2;
-            int y1 = drone->coord.x * CELL_SIZE + CELL_SIZE/2;
-            int x2 = drone->target.y * CELL_SIZE + CELL_SIZE/2;
-            int y2 = drone->target.x * CELL_SIZE + CELL_SIZE/2;
-            SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
-        }
-        node = node->next;
+// Culled: cells outside the window are never batched
+static void batch_cell(RectBatch *b, int x, int y) {
+    SDL_Rect rect;
+    if (cell_rect(x, y, &rect)) batch_add(b, rect.x, rect.y, rect.w, rect.h);
+}
+
+static void batch_flush(RectBatch *b, SDL_Color color) {
+    if (!b->count) return;
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    SDL_RenderFillRects(renderer, b->rects, b->count);
+    b->count = 0;
+}
+
+// A cross at the target location, as two thin rectangles
+static void batch_target_marker(RectBatch *b, int x, int y) {
+    SDL_Rect rect;
+    if (!cell_rect(x, y, &rect)) return;
+    int center_x = rect.x + rect.w / 2;
+    int center_y = rect.y + rect.h / 2;
+    int size = rect.w / 4;
+    batch_add(b, center_x - size, center_y, 2 * size + 1, 1);
+    batch_add(b, center_x, center_y - size, 1, 2 * size + 1);
+}
+
+static int lod_level(int count) {
+    int level = 0;
+    while (count > 1 && level < LOD_LEVELS - 1) {
+        count >>= 1;
+        level++;
     }
-    pthread_mutex_unlock(&drones->lock);
-} // draw_drones sonu
+    return level;
+}
 
-void draw_survivors() {
-    // Yeni: merkezi List *priority_survivors, *survivors ve *helpedsurvivors kullan
-    // Draw priority survivors (orphans) in orange
-    if (priority_survivors) {
-        pthread_mutex_lock(&priority_survivors->lock);
-        Node *pn = priority_survivors->head;
-        while (pn) {
-            Survivor *sv = *(Survivor**)pn->data;
-            if (sv) draw_cell(sv->coord.x, sv->coord.y, ORANGE);
-            pn = pn->next;
-        }
-        pthread_mutex_unlock(&priority_survivors->lock);
+// Zoomed out: count drones and survivors per map-aligned tile of
+// LOD_TILE_PX screen pixels and draw one shaded rectangle per occupied
+// tile. The number of rectangles is bounded by the window size.
+static void draw_density(const WorldSnapshot *snap) {
+    int cells_per_tile = (int)(LOD_TILE_PX / cell);
+    int first_col = (int)floor(view_col / cells_per_tile);
+    int first_row = (int)floor(view_row / cells_per_tile);
+    int tiles_w = window_width / LOD_TILE_PX + 2;
+    int tiles_h = window_height / LOD_TILE_PX + 2;
+    if (tiles_w * tiles_h > lod_capacity) {
+        int *s = realloc(lod_survivors, (size_t)tiles_w * tiles_h * sizeof(int));
+        if (s) lod_survivors = s;
+        int *d = realloc(lod_drones, (size_t)tiles_w * tiles_h * sizeof(int));
+        if (d) lod_drones = d;
+        if (!s || !d) return;
+        lod_capacity = tiles_w * tiles_h;
     }
-    extern List *survivors;
-    extern List *helpedsurvivors;
-    if (survivors) {
-        pthread_mutex_lock(&survivors->lock);
-        Node *node = survivors->head;
-        while (node) {
-            Survivor *s = *(Survivor **)node->data;
-            if (!s) { node = node->next; continue; }
-            // Normal survivors in red
-            draw_cell(s->coord.x, s->coord.y, RED);
-            node = node->next;
-        }
-        pthread_mutex_unlock(&survivors->lock);
+    memset(lod_survivors, 0, (size_t)tiles_w * tiles_h * sizeof(int));
+    memset(lod_drones, 0, (size_t)tiles_w * tiles_h * sizeof(int));
+    for (int i = 0; i < snap->survivor_count; i++) {
+        const SnapshotSurvivor *s = &snap->survivors[i];
+        if (s->kind == SNAP_SURVIVOR_HELPED) continue;
+        int tx = s->coord.y / cells_per_tile - first_col;
+        int ty = s->coord.x / cells_per_tile - first_row;
+        if (tx >= 0 && ty >= 0 && tx < tiles_w && ty < tiles_h) lod_survivors[ty * tiles_w + tx]++;
     }
-    if (helpedsurvivors) {
-        pthread_mutex_lock(&helpedsurvivors->lock);
-        Node *node = helpedsurvivors->head;
-        while (node) {
-            Survivor *s = *(Survivor **)node->data;
-            if (!s) { node = node->next; continue; }
-            draw_cell(s->coord.x, s->coord.y, PURPLE);
-            node = node->next;
+    for (int i = 0; i < snap->drone_count; i++) {
+        const SnapshotDrone *d = &snap->drones[i];
+        int tx = d->coord.y / cells_per_tile - first_col;
+        int ty = d->coord.x / cells_per_tile - first_row;
+        if (tx >= 0 && ty >= 0 && tx < tiles_w && ty < tiles_h) lod_drones[ty * tiles_w + tx]++;
+    }
+    for (int ty = 0; ty < tiles_h; ty++) {
+        for (int tx = 0; tx < tiles_w; tx++) {
+            int drones_here = lod_drones[ty * tiles_w + tx];
+            int survivors_here = lod_survivors[ty * tiles_w + tx];
+            if (!drones_here && !survivors_here) continue;
+            // Drones on top of survivors, as in the detailed view
+            int batch = drones_here ? BATCH_LOD_DRONES + lod_level(drones_here)
+                                    : BATCH_LOD_SURVIVORS + lod_level(survivors_here);
+            batch_add(&batches[batch], (first_col + tx) * LOD_TILE_PX - origin_x,
+                      (first_row + ty) * LOD_TILE_PX - origin_y, LOD_TILE_PX, LOD_TILE_PX);
         }
-        pthread_mutex_unlock(&helpedsurvivors->lock);
     }
+    for (int i = 0; i < LOD_LEVELS; i++) batch_flush(&batches[BATCH_LOD_SURVIVORS + i], LOD_SURVIVOR_SHADES[i]);
+    for (int i = 0; i < LOD_LEVELS; i++) batch_flush(&batches[BATCH_LOD_DRONES + i], LOD_DRONE_SHADES[i]);
+}
+
+// Everything below draws from the latest snapshot; the live lists and
+// their locks are never touched from the render thread
+void draw_drones(const WorldSnapshot *snap) {
+    for (int i = 0; i < snap->drone_count; i++) {
+        const SnapshotDrone *drone = &snap->drones[i];
+        batch_cell(&batches[drone->status == IDLE ? BATCH_BLUE : BATCH_GREEN], drone->coord.x, drone->coord.y);
+        if (cell >= GRID_MIN_PX) batch_target_marker(&batches[BATCH_YELLOW], drone->target.x, drone->target.y);
+    }
+    batch_flush(&batches[BATCH_BLUE], BLUE);
+    batch_flush(&batches[BATCH_GREEN], GREEN);
+    batch_flush(&batches[BATCH_YELLOW], YELLOW);
+    // Draw line to target if on mission (SDL clips what lies off screen)
+    SDL_SetRenderDrawColor(renderer, GREEN.r, GREEN.g, GREEN.b, GREEN.a);
+    int half = (int)cell / 2;
+    for (int i = 0; i < snap->drone_count; i++) {
+        const SnapshotDrone *drone = &snap->drones[i];
+        if (drone->status != ON_MISSION) continue;
+        int x1 = (int)floor(drone->coord.y * cell) - origin_x + half;
+        int y1 = (int)floor(drone->coord.x * cell) - origin_y + half;
+        int x2 = (int)floor(drone->target.y * cell) - origin_x + half;
+        int y2 = (int)floor(drone->target.x * cell) - origin_y + half;
+        if ((x1 < 0 && x2 < 0) || (y1 < 0 && y2 < 0) ||
+            (x1 >= window_width && x2 >= window_width) || (y1 >= window_height && y2 >= window_height)) continue;
+        SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+    }
+} // draw_drones sonu
+
+void draw_survivors(const WorldSnapshot *snap) {
+    // Priority survivors (orphans) in orange, waiting in red, helped in purple
+    for (int i = 0; i < snap->survivor_count; i++) {
+        const SnapshotSurvivor *s = &snap->survivors[i];
+        int batch = s->kind == SNAP_SURVIVOR_PRIORITY ? BATCH_ORANGE
+                  : s->kind == SNAP_SURVIVOR_HELPED ? BATCH_PURPLE : BATCH_RED;
+        batch_cell(&batches[batch], s->coord.x, s->coord.y);
+    }
+    batch_flush(&batches[BATCH_ORANGE], ORANGE);
+    batch_flush(&batches[BATCH_RED], RED);
+    batch_flush(&batches[BATCH_PURPLE], PURPLE);
 } // draw_survivors sonu
 
+// Lines every `pitch` pixels covering width x height, starting at 0
+static void draw_grid_lines(int pitch, int width, int height) {
+    RectBatch *b = &batches[BATCH_WHITE];
+    for (int y = 0; y <= height; y += pitch) batch_add(b, 0, y, width, 1);
+    for (int x = 0; x <= width; x += pitch) batch_add(b, x, 0, 1, height);
+    batch_flush(b, WHITE);
+}
 
 void draw_grid() {
-    SDL_SetRenderDrawColor(renderer, WHITE.r, WHITE.g, WHITE.b,
-                           WHITE.a);
-    for (int i = 0; i <= map.height; i++) {
-        SDL_RenderDrawLine(renderer, 0, i * CELL_SIZE, window_width,
-                           i * CELL_SIZE);
+    int pitch = (int)cell;
+    if (pitch < GRID_MIN_PX) return;
+    // Only the map's own area gets lines (the last row/column line included)
+    SDL_Rect area = { -origin_x, -origin_y, map.width * pitch + 1, map.height * pitch + 1 };
+    SDL_Rect screen = { 0, 0, window_width, window_height };
+    SDL_Rect clip;
+    if (!SDL_IntersectRect(&area, &screen, &clip)) return;
+    int width = window_width + pitch, height = window_height + pitch;
+    if (grid_texture && (grid_cell != pitch || grid_width != width || grid_height != height)) {
+        SDL_DestroyTexture(grid_texture);
+        grid_texture = NULL;
     }
-    for (int j = 0; j <= map.width; j++) {
-        SDL_RenderDrawLine(renderer, j * CELL_SIZE, 0, j * CELL_SIZE,
-                           window_height);
+    if (!grid_texture && !grid_texture_failed) {
+        grid_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!grid_texture || SDL_SetRenderTarget(renderer, grid_texture) < 0) {
+            // No render targets: keep drawing the lines every frame
+            if (grid_texture) SDL_DestroyTexture(grid_texture);
+            grid_texture = NULL;
+            grid_texture_failed = 1;
+        } else {
+            SDL_SetTextureBlendMode(grid_texture, SDL_BLENDMODE_BLEND);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+            SDL_RenderClear(renderer);
+            draw_grid_lines(pitch, width, height);
+            SDL_SetRenderTarget(renderer, NULL);
+            grid_cell = pitch;
+            grid_width = width;
+            grid_height = height;
+        }
+    }
+    SDL_RenderSetClipRect(renderer, &clip);
+    // Shift by the sub-cell part of the scroll position
+    int shift_x = ((origin_x % pitch) + pitch) % pitch;
+    int shift_y = ((origin_y % pitch) + pitch) % pitch;
+    if (grid_texture) {
+        SDL_Rect dst = { -shift_x, -shift_y, width, height };
+        SDL_RenderCopy(renderer, grid_texture, NULL, &dst);
+    } else {
+        RectBatch *b = &batches[BATCH_WHITE];
+        for (int y = -shift_y; y <= window_height; y += pitch) batch_add(b, 0, y, window_width, 1);
+        for (int x = -shift_x; x <= window_width; x += pitch) batch_add(b, x, 0, 1, window_height);
+        batch_flush(b, WHITE);
     }
+    SDL_RenderSetClipRect(renderer, NULL);
 }
 
 int draw_map() {
@@ -209,6 +414,7 @@ int draw_map() {
         fprintf(stderr, "Renderer is NULL in draw_map\n");
         return 1;
     }
+    uint64_t frame_start = monotonic_ns();
 
     if (SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255) < 0) {
         fprintf(stderr, "SDL_SetRenderDrawColor Error in draw_map: %s\n", SDL_GetError());
@@ -220,15 +426,24 @@ int draw_map() {
         return 1;
     }
 
-    draw_survivors();
-    draw_drones();
-    draw_grid();
+    begin_frame();
+    const WorldSnapshot *snap = snapshot_acquire();
+    if (cell < LOD_MAX_PX) {
+        draw_density(snap);
+    } else {
+        draw_survivors(snap);
+        draw_drones(snap);
+        draw_grid();
+    }
 
+    // Frame time excludes present, which may wait for vsync
+    metrics_observe(HIST_FRAME_TIME, monotonic_ns() - frame_start);
     SDL_RenderPresent(renderer);
     return 0;
 }
 
 int check_events() {
+    static int dragging;
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
             case SDL_QUIT:
@@ -237,13 +452,44 @@ int check_events() {
                 switch (event.window.event) {
                     case SDL_WINDOWEVENT_CLOSE:
                         return 1;
+                    case SDL_WINDOWEVENT_SIZE_CHANGED:
+                        SDL_GetWindowSize(window, &window_width, &window_height);
+                        view_clamp();
+                        break;
                     case SDL_WINDOWEVENT_EXPOSED:
                         draw_map();
                         break;
                 }
                 break;
             case SDL_KEYDOWN:
-                if (event.key.keysym.sym == SDLK_ESCAPE) return 1;
+                // Arrows/WASD pan, +/- zoom, 0/Home fit the whole map
+                switch (event.key.keysym.sym) {
+                    case SDLK_ESCAPE: return 1;
+                    case SDLK_LEFT: case SDLK_a: view_pan_pixels(-window_width / 8, 0); break;
+                    case SDLK_RIGHT: case SDLK_d: view_pan_pixels(window_width / 8, 0); break;
+                    case SDLK_UP: case SDLK_w: view_pan_pixels(0, -window_height / 8); break;
+                    case SDLK_DOWN: case SDLK_s: view_pan_pixels(0, window_height / 8); break;
+                    case SDLK_PLUS: case SDLK_EQUALS: view_zoom(1, window_width / 2, window_height / 2); break;
+                    case SDLK_MINUS: view_zoom(-1, window_width / 2, window_height / 2); break;
+                    case SDLK_0: case SDLK_HOME: view_fit(); break;
+                }
+                break;
+            case SDL_MOUSEWHEEL: {
+                // Zoom around the cursor
+                int mx, my;
+                SDL_GetMouseState(&mx, &my);
+                view_zoom(event.wheel.y > 0 ? 1 : event.wheel.y < 0 ? -1 : 0, mx, my);
+                break;
+            }
+            case SDL_MOUSEBUTTONDOWN:
+                if (event.button.button == SDL_BUTTON_LEFT) dragging = 1;
+                break;
+            case SDL_MOUSEBUTTONUP:
+                if (event.button.button == SDL_BUTTON_LEFT) dragging = 0;
+                break;
+            case SDL_MOUSEMOTION:
+                // Drag to pan
+                if (dragging) view_pan_pixels(-event.motion.xrel, -event.motion.yrel);
                 break;
         }
     }
@@ -251,6 +497,7 @@ int check_events() {
 }
 
 void quit_all() {
+    if (grid_texture) SDL_DestroyTexture(grid_texture);
     if (renderer) SDL_DestroyRenderer(renderer);
     if (window) SDL_DestroyWindow(window);
     SDL_Quit();